@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../motor_controller.hpp"
+#include "agitation_sequence.hpp"
+#include "packed_sequence.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Reads the motor direction of a packed sequence at a point in time.
+ *
+ * A step's agitation is a pure function of the time into the step, so the
+ * engine keeps no movement objects or loop cursors: each tick it walks the
+ * packed words from flash to the entry that covers the current time. A loop
+ * takes its time modulo the length of its body, so finding the position in
+ * a nested loop costs a pass over the words, not one per iteration. Pauses,
+ * ticks that arrive late and resumes need no bookkeeping either. The same
+ * walk tells how long the entry has left, so the app can sleep until the
+ * motor may change direction instead of polling for it.
+ *
+ * A wait inside a loop holds until the loop's time limit, as the loop
+ * movement used to. A wait on the top level ends the timed part of the step.
+ */
+namespace agitation_pattern {
+
+// Length of a sequence that never ends
+constexpr uint32_t FOREVER = UINT32_MAX;
+// Deeper loops are treated as empty
+constexpr size_t MAX_DEPTH = 8;
+
+inline uint32_t saturating_add(uint32_t a, uint32_t b) {
+    return a > FOREVER - b ? FOREVER : a + b;
+}
+
+inline uint32_t saturating_multiply(uint32_t a, uint32_t b) {
+    return b != 0 && a > FOREVER / b ? FOREVER : a * b;
+}
+
+inline size_t body_of(const uint32_t* words, size_t loop) {
+    return loop + ((words[loop] >> packed_sequence::OFFSET_SHIFT) & packed_sequence::OFFSET_MASK);
+}
+
+inline size_t body_length_of(uint32_t word) {
+    return (word >> packed_sequence::LENGTH_SHIFT) & packed_sequence::LENGTH_MASK;
+}
+
+uint32_t span(const uint32_t* words, size_t first, size_t length, size_t depth);
+
+/**
+ * @brief Length of the loop at word index loop
+ * @param body Set to the length of one pass through the body
+ */
+inline uint32_t loop_duration(const uint32_t* words, size_t loop, size_t depth, uint32_t& body) {
+    uint32_t word = words[loop];
+    body = depth + 1 < MAX_DEPTH ?
+               span(words, body_of(words, loop), body_length_of(word), depth + 1) :
+               0;
+    if(body == 0) {
+        return 0;
+    }
+    uint32_t count = word & packed_sequence::COUNT_MASK;
+    uint32_t limit = (word & packed_sequence::LIMITED_BIT) ? words[loop + 1] : 0;
+    uint32_t total = count > 0 ? saturating_multiply(body, count) : FOREVER;
+    return limit > 0 && limit < total ? limit : total;
+}
+
+// Length of length entries starting at word index first. Recursion only
+// follows loop nesting, which MAX_DEPTH bounds.
+inline uint32_t span(const uint32_t* words, size_t first, size_t length, size_t depth) {
+    uint32_t total = 0;
+    size_t at = first;
+    for(size_t i = 0; i < length; i++) {
+        uint32_t word = words[at];
+        auto type = static_cast<AgitationMovementType>(word >> packed_sequence::TYPE_SHIFT);
+        uint32_t body;
+        uint32_t duration = type == AgitationMovementTypeLoop     ? loop_duration(words, at, depth, body) :
+                            type == AgitationMovementTypeWaitUser ? FOREVER :
+                                                                    word & packed_sequence::DURATION_MASK;
+        total = saturating_add(total, duration);
+        at += packed_sequence::entry_words(word);
+    }
+    return total;
+}
+
+struct Timing {
+    // Up to the first top-level wait, FOREVER if the sequence never ends
+    uint32_t duration_ms;
+    // Whether a top-level wait ends it
+    bool waits;
+};
+
+inline Timing measure(const PackedSequence& sequence) {
+    Timing timing{0, false};
+    size_t at = 0;
+    for(size_t i = 0; i < sequence.length; i++) {
+        uint32_t word = sequence.words[at];
+        auto type = static_cast<AgitationMovementType>(word >> packed_sequence::TYPE_SHIFT);
+        if(type == AgitationMovementTypeWaitUser) {
+            timing.waits = true;
+            break;
+        }
+        uint32_t body;
+        timing.duration_ms = saturating_add(
+            timing.duration_ms,
+            type == AgitationMovementTypeLoop ? loop_duration(sequence.words, at, 0, body) :
+                                                word & packed_sequence::DURATION_MASK);
+        at += packed_sequence::entry_words(word);
+    }
+    return timing;
+}
+
+struct Position {
+    MotorController::Direction direction;
+    // Until the entry covering the time ends, FOREVER if it never does
+    uint32_t remaining_ms;
+};
+
+/**
+ * @brief Direction the motor turns elapsed_ms into the sequence, and how
+ * long until the next entry may turn it another way. Stopped forever past
+ * the end.
+ */
+inline Position position_at(const PackedSequence& sequence, uint32_t elapsed_ms) {
+    const uint32_t* words = sequence.words;
+    size_t at = 0;
+    size_t remaining = sequence.length;
+    size_t depth = 0;
+    // Time left in the innermost loop holding the entry
+    uint32_t loop_left = FOREVER;
+
+    while(remaining > 0) {
+        uint32_t word = words[at];
+        auto type = static_cast<AgitationMovementType>(word >> packed_sequence::TYPE_SHIFT);
+
+        if(type == AgitationMovementTypeLoop) {
+            uint32_t body;
+            uint32_t duration = loop_duration(words, at, depth, body);
+            if(elapsed_ms < duration) {
+                // Into the pass through the body that covers the time
+                if(duration - elapsed_ms < loop_left) {
+                    loop_left = duration - elapsed_ms;
+                }
+                elapsed_ms %= body;
+                remaining = body_length_of(word);
+                at = body_of(words, at);
+                depth++;
+                continue;
+            }
+            elapsed_ms -= duration;
+        } else {
+            uint32_t duration = type == AgitationMovementTypeWaitUser ?
+                                    FOREVER :
+                                    word & packed_sequence::DURATION_MASK;
+            if(elapsed_ms < duration) {
+                Position position{MotorController::Direction::Stopped, loop_left};
+                if(duration - elapsed_ms < loop_left) {
+                    position.remaining_ms = duration - elapsed_ms;
+                }
+                if(type == AgitationMovementTypeCW) {
+                    position.direction = MotorController::Direction::Clockwise;
+                } else if(type == AgitationMovementTypeCCW) {
+                    position.direction = MotorController::Direction::CounterClockwise;
+                }
+                return position;
+            }
+            elapsed_ms -= duration;
+        }
+        at += packed_sequence::entry_words(word);
+        remaining--;
+    }
+    return {MotorController::Direction::Stopped, FOREVER};
+}
+
+inline MotorController::Direction direction_at(const PackedSequence& sequence, uint32_t elapsed_ms) {
+    return position_at(sequence, elapsed_ms).direction;
+}
+
+} // namespace agitation_pattern
@@ -1,7 +1,22 @@
 #pragma once
 
 #include "processes/common_sequences.hpp"
+#include "processes/cinestill_process.hpp"
 #include "processes/bw_standard_process.hpp"
 #include "processes/stand_dev_process.hpp"
 #include "processes/continuous_gentle_process.hpp"
 #include "processes/c41_process.hpp"
+#include "processes/rotary_process.hpp"
+
+// Processes offered by the app, the first one is selected at start
+static const AgitationProcessStatic* const AGITATION_PROCESSES[] = {
+    &CINESTILL_C41_STATIC,
+    &C41_FULL_PROCESS_STATIC,
+    &BW_STANDARD_DEV_STATIC,
+    &STAND_DEV_STATIC,
+    &CONTINUOUS_GENTLE_STATIC,
+    &BW_ROTARY_STATIC,
+    &C41_ROTARY_STATIC,
+};
+static constexpr size_t AGITATION_PROCESS_COUNT =
+    sizeof(AGITATION_PROCESSES) / sizeof(AGITATION_PROCESSES[0]);
@@ -27,9 +27,15 @@ typedef enum {
 typedef struct AgitationMovementStatic AgitationMovementStatic;
 typedef struct AgitationStepStatic AgitationStepStatic;
 
+/**
+ * @brief Duration in milliseconds from seconds, which may be fractional
+ */
+#define AGITATION_SECONDS(seconds) ((uint32_t)((seconds) * 1000.0 + 0.5))
+
 /**
  * @brief Static version of movement
  * For loops, duration is ignored. For other types, count and sequence are ignored.
+ * Durations are in milliseconds.
  */
 struct AgitationMovementStatic {
     AgitationMovementType type;
@@ -48,15 +54,44 @@ struct AgitationMovementStatic {
     };
 };
 
+/**
+ * @brief Sequence packed into 32-bit words, see packed_sequence.hpp
+ */
+typedef struct {
+    const uint32_t* words;
+    size_t length; // Movements on the top level
+} PackedSequence;
+
+/**
+ * @brief How long a step runs
+ */
+typedef enum {
+    // As long as the sequence, up to its first top-level wait
+    AgitationTimeModelSequence = 0,
+    // duration_ms, repeating the sequence if it ends earlier
+    AgitationTimeModelFixed = 1,
+    // Looked up in dev_table for the temperature, push/pull and roll count,
+    // repeating the sequence if it ends earlier
+    AgitationTimeModelDevTable = 2,
+} AgitationTimeModel;
+
+typedef struct DevTimeTable DevTimeTable;
+
 /**
  * @brief Static version of step
+ * An empty sequence turns the motor clockwise for the whole step.
  */
 struct AgitationStepStatic {
     const char* name;
     const char* description;
     float temperature;
-    const AgitationMovementStatic* sequence;
-    size_t sequence_length;
+    PackedSequence sequence;
+    AgitationTimeModel time_model = AgitationTimeModelSequence;
+    uint32_t duration_ms = 0; // For AgitationTimeModelFixed
+    const DevTimeTable* dev_table = nullptr; // For AgitationTimeModelDevTable
+    // Wait for the user at the end of the step; a top-level wait in the
+    // sequence does the same
+    bool requires_confirmation = false;
 };
 
 /**
@@ -68,6 +103,7 @@ typedef struct {
     const char* tank_type;
     const char* chemistry;
     float temperature;
+    bool fahrenheit = false; // Unit of the process and step temperatures
     const AgitationStepStatic* steps;
     size_t steps_length;
 } AgitationProcessStatic;
@@ -216,32 +252,32 @@ typedef struct {
 /**
  * @brief Standard inversion sequence
  */
-#define AGITATION_STANDARD_INVERSION                         \
-    {                                                        \
-        {.type = AgitationMovementTypeCW, .duration = 1},    \
-        {.type = AgitationMovementTypePause, .duration = 1}, \
-        {.type = AgitationMovementTypeCCW, .duration = 1},   \
-        {.type = AgitationMovementTypePause, .duration = 1}, \
+#define AGITATION_STANDARD_INVERSION                                            \
+    {                                                                           \
+        {.type = AgitationMovementTypeCW, .duration = AGITATION_SECONDS(1)},    \
+        {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)}, \
+        {.type = AgitationMovementTypeCCW, .duration = AGITATION_SECONDS(1)},   \
+        {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)}, \
     }
 
 /**
  * @brief Initial agitation sequence with loop
  */
-#define AGITATION_INITIAL_SEQUENCE                                         \
-    {                                                                      \
-        {.type = AgitationMovementTypeLoop,                                \
-         .loop =                                                           \
-             {.count = 4,                                                  \
-              .max_duration = 0,                                           \
-              .sequence =                                                  \
-                  (AgitationMovementStatic[]){                             \
-                      {.type = AgitationMovementTypeCW, .duration = 1},    \
-                      {.type = AgitationMovementTypePause, .duration = 1}, \
-                      {.type = AgitationMovementTypeCCW, .duration = 1},   \
-                      {.type = AgitationMovementTypePause, .duration = 1}, \
-                  },                                                       \
-              .sequence_length = 4}},                                      \
-        {.type = AgitationMovementTypePause, .duration = 24},              \
+#define AGITATION_INITIAL_SEQUENCE                                                            \
+    {                                                                                         \
+        {.type = AgitationMovementTypeLoop,                                                   \
+         .loop =                                                                              \
+             {.count = 4,                                                                     \
+              .max_duration = 0,                                                              \
+              .sequence =                                                                     \
+                  (AgitationMovementStatic[]){                                                \
+                      {.type = AgitationMovementTypeCW, .duration = AGITATION_SECONDS(1)},    \
+                      {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)}, \
+                      {.type = AgitationMovementTypeCCW, .duration = AGITATION_SECONDS(1)},   \
+                      {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)}, \
+                  },                                                                          \
+              .sequence_length = 4}},                                                         \
+        {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(24)},              \
     }
 
 //------------------------------------------------------------------------------
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "dev_time_table.hpp"
+#include <furi.h>
+#include <stdlib.h>
+#include <string.h>
+#include <storage/storage.h>
+
+#define DEV_TIME_LOADER_TAG "DevTimeLoader"
+
+/**
+ * @brief A DevTimeTable read from text, so new chemistry is a file on the
+ * SD card rather than code.
+ *
+ * One directive per line, # starts a comment:
+ * ```
+ * # Rodinal 1+50 and 1+25
+ * unit fahrenheit
+ * axis temperature 65 68 72 75
+ * axis dilution 25 50
+ * exhaustion 0
+ * minutes 9 8 7 6
+ * minutes 17 14 12 10.5
+ * ```
+ * Axes come first, the first one interpolated as a curve, see
+ * dev_time_table.hpp. Axis kinds are temperature, push_pull, dilution and
+ * rolls. Minutes list the cells with the first axis varying fastest, over as
+ * many lines as convenient, - marking a cell with no time. unit (celsius,
+ * the default, or fahrenheit) and exhaustion are optional.
+ *
+ * Everything is held in fixed arrays and the slopes are computed once the
+ * file is read. The object is a few kilobytes: keep it static or in the app,
+ * not on the 2 KB app stack.
+ */
+class LoadedDevTimeTable {
+public:
+    static constexpr size_t MAX_POINTS = 16;
+    static constexpr size_t MAX_CELLS = 256;
+    static constexpr size_t MAX_LINE = 128;
+
+    LoadedDevTimeTable() {
+        clear();
+    }
+
+    void clear() {
+        table = DevTimeTable{};
+        table.minutes = minutes;
+        table.slopes = slopes;
+        cells = 0;
+        error_line = 0;
+        line_number = 0;
+        finished = false;
+    }
+
+    /**
+     * @brief Read a table from a file
+     * @return false if the file cannot be read or is malformed, see
+     * get_error_line()
+     */
+    bool load(Storage* storage, const char* path) {
+        clear();
+        File* file = storage_file_alloc(storage);
+        bool ok = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+        if(!ok) {
+            FURI_LOG_E(DEV_TIME_LOADER_TAG, "Cannot open %s", path);
+        }
+
+        // Lines are assembled from small chunks to keep the stack small
+        char line[MAX_LINE];
+        size_t length = 0;
+        char chunk[32];
+        size_t read = 0;
+        while(ok && (read = storage_file_read(file, chunk, sizeof(chunk))) > 0) {
+            for(size_t i = 0; ok && i < read; i++) {
+                if(chunk[i] == '\n') {
+                    line[length] = '\0';
+                    ok = parse_line(line);
+                    length = 0;
+                } else if(length + 1 < MAX_LINE) {
+                    line[length++] = chunk[i];
+                } else {
+                    FURI_LOG_E(DEV_TIME_LOADER_TAG, "Line %u too long", (unsigned int)(line_number + 1));
+                    error_line = line_number + 1;
+                    ok = false;
+                }
+            }
+        }
+        if(ok && length > 0) {
+            line[length] = '\0';
+            ok = parse_line(line);
+        }
+
+        storage_file_close(file);
+        storage_file_free(file);
+        return ok && finish();
+    }
+
+    /**
+     * @brief Take one line of the text format
+     * @return false if the line is malformed
+     */
+    bool parse_line(char* line) {
+        line_number++;
+        char* comment = strchr(line, '#');
+        if(comment) {
+            *comment = '\0';
+        }
+
+        char* rest = nullptr;
+        char* directive = strtok_r(line, " \t\r", &rest);
+        if(!directive) {
+            return true;
+        }
+        if(strcmp(directive, "axis") == 0) {
+            return parse_axis(rest);
+        }
+        if(strcmp(directive, "exhaustion") == 0) {
+            char* value = strtok_r(nullptr, " \t\r", &rest);
+            if(!value || !parse_number(value, table.exhaustion_per_roll)) {
+                return fail("bad exhaustion");
+            }
+            return true;
+        }
+        if(strcmp(directive, "unit") == 0) {
+            char* unit = strtok_r(nullptr, " \t\r", &rest);
+            if(unit && strcmp(unit, "celsius") == 0) {
+                table.fahrenheit = false;
+                return true;
+            }
+            if(unit && strcmp(unit, "fahrenheit") == 0) {
+                table.fahrenheit = true;
+                return true;
+            }
+            return fail("unknown unit");
+        }
+        if(strcmp(directive, "minutes") == 0) {
+            return parse_minutes(rest);
+        }
+        return fail("unknown directive");
+    }
+
+    /**
+     * @brief Check the table and compute its slopes once every line is in
+     * @return false if the minutes don't fill the axes
+     */
+    bool finish() {
+        if(!dev_time_table::is_valid(table)) {
+            return fail("axes missing, empty or not rising");
+        }
+        if(cells != dev_time_table::cell_count(table)) {
+            FURI_LOG_E(
+                DEV_TIME_LOADER_TAG,
+                "%u minutes for %u cells",
+                (unsigned int)cells,
+                (unsigned int)dev_time_table::cell_count(table));
+            error_line = line_number;
+            return false;
+        }
+        dev_time_table::fill_slopes(
+            table.axes[0].points, table.axes[0].count, minutes, cells, slopes);
+        finished = true;
+        return true;
+    }
+
+    // Usable once load() or finish() succeeded
+    const DevTimeTable* get() const {
+        return finished ? &table : nullptr;
+    }
+
+    // Line of the first error, 0 if none
+    size_t get_error_line() const {
+        return error_line;
+    }
+
+private:
+    bool fail(const char* reason) {
+        FURI_LOG_E(DEV_TIME_LOADER_TAG, "Line %u: %s", (unsigned int)line_number, reason);
+        if(error_line == 0) {
+            error_line = line_number;
+        }
+        return false;
+    }
+
+    static bool parse_number(const char* text, float& value) {
+        char* end = nullptr;
+        value = strtof(text, &end);
+        return end != text && *end == '\0';
+    }
+
+    static bool parse_kind(const char* name, DevTimeAxisKind& kind) {
+        static const struct {
+            const char* name;
+            DevTimeAxisKind kind;
+        } kinds[] = {
+            {"temperature", DevTimeAxisKind::Temperature},
+            {"push_pull", DevTimeAxisKind::PushPull},
+            {"dilution", DevTimeAxisKind::Dilution},
+            {"rolls", DevTimeAxisKind::Rolls},
+        };
+        for(const auto& entry : kinds) {
+            if(strcmp(name, entry.name) == 0) {
+                kind = entry.kind;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool parse_axis(char* rest) {
+        if(cells > 0) {
+            return fail("axis after minutes");
+        }
+        if(table.axis_count == DEV_TIME_MAX_AXES) {
+            return fail("too many axes");
+        }
+        DevTimeAxis& axis = table.axes[table.axis_count];
+        char* name = strtok_r(nullptr, " \t\r", &rest);
+        if(!name || !parse_kind(name, axis.kind)) {
+            return fail("unknown axis");
+        }
+
+        float* values = points[table.axis_count];
+        size_t count = 0;
+        for(char* token = strtok_r(nullptr, " \t\r", &rest); token;
+            token = strtok_r(nullptr, " \t\r", &rest)) {
+            if(count == MAX_POINTS) {
+                return fail("too many points");
+            }
+            if(!parse_number(token, values[count])) {
+                return fail("bad point");
+            }
+            count++;
+        }
+        axis.points = values;
+        axis.count = count;
+        table.axis_count++;
+        return true;
+    }
+
+    bool parse_minutes(char* rest) {
+        for(char* token = strtok_r(nullptr, " \t\r", &rest); token;
+            token = strtok_r(nullptr, " \t\r", &rest)) {
+            if(cells == MAX_CELLS) {
+                return fail("too many minutes");
+            }
+            if(strcmp(token, "-") == 0) {
+                minutes[cells] = -1.0f;
+            } else if(!parse_number(token, minutes[cells])) {
+                return fail("bad minutes");
+            }
+            cells++;
+        }
+        return true;
+    }
+
+    DevTimeTable table;
+    float points[DEV_TIME_MAX_AXES][MAX_POINTS];
+    float minutes[MAX_CELLS];
+    float slopes[MAX_CELLS];
+    size_t cells;
+    size_t line_number;
+    size_t error_line;
+    bool finished;
+};
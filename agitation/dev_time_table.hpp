@@ -0,0 +1,413 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <furi.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define DEV_TIME_TAG "DevTime"
+
+/**
+ * @brief Tabulated developer times over up to four dimensions.
+ *
+ * A table is a grid of minutes over axes such as temperature, push/pull,
+ * dilution and roll count, in any order and combination. The first axis is
+ * the one times change fastest and least linearly along, usually
+ * temperature. It is interpolated with monotone cubic Hermite curves, so a
+ * time never overshoots its neighbours the way a plain cubic can. The other
+ * axes are interpolated linearly, which is exact for the whole-stop
+ * push/pull and dilution points that tables list.
+ *
+ * The cubic needs the slope at each cell. Slopes are computed once, at
+ * compile time for tables in flash (DEV_TIME_SLOPES) or when a table is
+ * loaded from SD, so a lookup is a few multiply-adds per corner of the
+ * surrounding grid cell.
+ *
+ * A negative time marks a cell the chemistry has no time for, like a push
+ * not recommended at low temperature. Looking up a point that needs such a
+ * cell, or a point outside the grid, gives a negative result.
+ *
+ * Minutes are stored with the first axis varying fastest: the cell at
+ * indices i0, i1, i2 is minutes[i0 + n0 * (i1 + n1 * i2)].
+ */
+
+enum class DevTimeAxisKind : uint8_t {
+    Temperature,
+    PushPull, // Stops, negative for pulls
+    Dilution, // Parts of water per part of developer, 50 for 1+50
+    Rolls, // Rolls developed in the chemistry, this one included
+};
+
+constexpr size_t DEV_TIME_MAX_AXES = 4;
+
+struct DevTimeAxis {
+    DevTimeAxisKind kind;
+    const float* points; // Rising
+    size_t count;
+};
+
+struct DevTimeTable {
+    DevTimeAxis axes[DEV_TIME_MAX_AXES];
+    size_t axis_count;
+    const float* minutes;
+    // Slope of the minutes along the first axis at each cell
+    const float* slopes;
+    // Extra time for each roll developed before, compounding: 0.02 is 2%.
+    // Only used by tables without a Rolls axis.
+    float exhaustion_per_roll;
+    // Unit of the temperature axis, probe readings are in Celsius
+    bool fahrenheit;
+};
+
+/**
+ * @brief Point to look a time up at. Values for axes a table does not have
+ * are ignored.
+ */
+struct DevTimeQuery {
+    float temperature;
+    float push_pull;
+    float dilution; // 0 for the first dilution of the table
+    float rolls;
+};
+
+/**
+ * @brief The curve of a table along its first axis between two grid points,
+ * with the other axes fixed: two times and their slopes, enough to evaluate
+ * any point in between without going back to the table
+ */
+struct DevTimeSegment {
+    float x0;
+    float x1; // x0 when the segment is a single grid point
+    float y0;
+    float y1;
+    // Slopes scaled to the width of the segment
+    float m0;
+    float m1;
+
+    bool covers(float x) const {
+        return x >= x0 && x <= x1;
+    }
+
+    // Cubic Hermite in Horner form
+    float at(float x) const {
+        if(x1 == x0) {
+            return y0;
+        }
+        float t = (x - x0) / (x1 - x0);
+        float dy = y1 - y0;
+        return y0 + t * (m0 + t * ((3 * dy - 2 * m0 - m1) + t * (m0 + m1 - 2 * dy)));
+    }
+};
+
+namespace dev_time_table {
+
+constexpr size_t cell_count(const DevTimeTable& table) {
+    size_t cells = table.axis_count > 0 ? 1 : 0;
+    for(size_t i = 0; i < table.axis_count; i++) {
+        cells *= table.axes[i].count;
+    }
+    return cells;
+}
+
+// Whether the axes are usable and each is a kind at most once
+constexpr bool is_valid(const DevTimeTable& table) {
+    if(table.axis_count == 0 || table.axis_count > DEV_TIME_MAX_AXES || !table.minutes ||
+       !table.slopes) {
+        return false;
+    }
+    for(size_t i = 0; i < table.axis_count; i++) {
+        const DevTimeAxis& axis = table.axes[i];
+        if(!axis.points || axis.count == 0) {
+            return false;
+        }
+        for(size_t j = 1; j < axis.count; j++) {
+            if(!(axis.points[j] > axis.points[j - 1])) {
+                return false;
+            }
+        }
+        for(size_t j = 0; j < i; j++) {
+            if(table.axes[j].kind == axis.kind) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Monotone slopes along the first axis (Fritsch-Butland, as used by
+ * PCHIP), computed separately for each run of available cells
+ * @param out Indexable by cell, sized like minutes
+ */
+template<typename Out>
+constexpr void fill_slopes(
+    const float* points,
+    size_t count,
+    const float* minutes,
+    size_t cells,
+    Out& out) {
+    for(size_t row = 0; row + count <= cells; row += count) {
+        const float* y = minutes + row;
+        size_t start = 0;
+        while(start < count) {
+            if(y[start] < 0) {
+                out[row + start] = 0;
+                start++;
+                continue;
+            }
+            size_t end = start + 1;
+            while(end < count && y[end] >= 0) {
+                end++;
+            }
+
+            // Cells start to end - 1 are available
+            for(size_t j = start; j < end; j++) {
+                float slope = 0;
+                if(j > start && j + 1 < end) {
+                    float h0 = points[j] - points[j - 1];
+                    float h1 = points[j + 1] - points[j];
+                    float d0 = (y[j] - y[j - 1]) / h0;
+                    float d1 = (y[j + 1] - y[j]) / h1;
+                    if(d0 * d1 > 0) {
+                        float w0 = 2 * h1 + h0;
+                        float w1 = h1 + 2 * h0;
+                        slope = (w0 + w1) / (w0 / d0 + w1 / d1);
+                    }
+                } else if(end - start == 2) {
+                    slope = (y[start + 1] - y[start]) / (points[start + 1] - points[start]);
+                } else if(end - start > 2) {
+                    // End of the run: three point estimate from the two
+                    // intervals next to it, kept from overshooting
+                    int step = j == start ? 1 : -1;
+                    size_t near = j + step;
+                    size_t far = near + step;
+                    float h0 = points[near] - points[j];
+                    float h1 = points[far] - points[near];
+                    float d0 = (y[near] - y[j]) / h0;
+                    float d1 = (y[far] - y[near]) / h1;
+                    slope = ((2 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+                    if(slope * d0 <= 0) {
+                        slope = 0;
+                    } else if(d0 * d1 <= 0 && slope / d0 > 3) {
+                        slope = 3 * d0;
+                    }
+                }
+                out[row + j] = slope;
+            }
+            start = end;
+        }
+    }
+}
+
+/**
+ * @brief Slopes of a table in flash, see DEV_TIME_SLOPES
+ */
+template<size_t Count, size_t Cells>
+constexpr std::array<float, Cells> slopes(const float (&points)[Count], const float (&minutes)[Cells]) {
+    static_assert(Cells % Count == 0, "Minutes do not fill the rows of the first axis");
+    std::array<float, Cells> out{};
+    fill_slopes(points, Count, minutes, Cells, out);
+    return out;
+}
+
+/**
+ * @brief Finds the grid interval holding value
+ * @param index Set to the point at or below value
+ * @param fraction Set to how far value is towards the next point
+ * @return false if value is outside the axis
+ */
+inline bool locate(const DevTimeAxis& axis, float value, size_t& index, float& fraction) {
+    const float* points = axis.points;
+    if(!(value >= points[0]) || !(value <= points[axis.count - 1])) {
+        return false;
+    }
+    index = 0;
+    while(index + 1 < axis.count && points[index + 1] <= value) {
+        index++;
+    }
+    fraction = index + 1 < axis.count ?
+                   (value - points[index]) / (points[index + 1] - points[index]) :
+                   0.0f;
+    return true;
+}
+
+inline float query_value(const DevTimeAxis& axis, const DevTimeQuery& query) {
+    switch(axis.kind) {
+    case DevTimeAxisKind::Temperature:
+        return query.temperature;
+    case DevTimeAxisKind::PushPull:
+        return query.push_pull;
+    case DevTimeAxisKind::Dilution:
+        return query.dilution > 0 ? query.dilution : axis.points[0];
+    default:
+        return query.rolls;
+    }
+}
+
+/**
+ * @brief Finds the segment of the first axis holding the query's value
+ * there, blending the corners of the surrounding cell on the other axes.
+ * The Hermite curve is linear in its times and slopes, so blending those is
+ * the same as blending the curves.
+ * @return false if the table has no time at the query
+ */
+inline bool segment_at(const DevTimeTable& table, const DevTimeQuery& query, DevTimeSegment& segment) {
+    if(table.axis_count == 0) {
+        return false;
+    }
+
+    size_t index[DEV_TIME_MAX_AXES]{};
+    float fraction[DEV_TIME_MAX_AXES]{};
+    size_t stride[DEV_TIME_MAX_AXES]{};
+    bool tabulates_rolls = false;
+    size_t cell_stride = 1;
+    for(size_t i = 0; i < table.axis_count; i++) {
+        const DevTimeAxis& axis = table.axes[i];
+        if(!locate(axis, query_value(axis, query), index[i], fraction[i])) {
+            return false;
+        }
+        stride[i] = cell_stride;
+        cell_stride *= axis.count;
+        tabulates_rolls |= axis.kind == DevTimeAxisKind::Rolls;
+    }
+
+    const DevTimeAxis& first = table.axes[0];
+    // The upper end is used if every weighted corner has a time there
+    bool upper_end = index[0] + 1 < first.count;
+    float y0 = 0, y1 = 0, m0 = 0, m1 = 0;
+    for(size_t corner = 0; corner < (size_t(1) << (table.axis_count - 1)); corner++) {
+        float weight = 1.0f;
+        size_t cell = index[0];
+        for(size_t i = 1; i < table.axis_count; i++) {
+            bool upper = corner & (size_t(1) << (i - 1));
+            weight *= upper ? fraction[i] : 1.0f - fraction[i];
+            cell += (index[i] + (upper ? 1 : 0)) * stride[i];
+        }
+        if(weight == 0) {
+            continue;
+        }
+        if(table.minutes[cell] < 0) {
+            return false;
+        }
+        y0 += weight * table.minutes[cell];
+        m0 += weight * table.slopes[cell];
+        if(upper_end && table.minutes[cell + 1] >= 0) {
+            y1 += weight * table.minutes[cell + 1];
+            m1 += weight * table.slopes[cell + 1];
+        } else {
+            upper_end = false;
+        }
+    }
+    if(!upper_end && fraction[0] > 0) {
+        return false;
+    }
+
+    float scale = 1.0f;
+    if(!tabulates_rolls && query.rolls > 1) {
+        scale = std::pow(1.0f + table.exhaustion_per_roll, query.rolls - 1);
+    }
+    segment.x0 = first.points[index[0]];
+    segment.x1 = upper_end ? first.points[index[0] + 1] : segment.x0;
+    float width = segment.x1 - segment.x0;
+    segment.y0 = y0 * scale;
+    segment.y1 = upper_end ? y1 * scale : segment.y0;
+    segment.m0 = m0 * scale * width;
+    segment.m1 = m1 * scale * width;
+    return true;
+}
+
+} // namespace dev_time_table
+
+/**
+ * @brief Developer time in minutes at a point of the table
+ * @return A negative value if the table has no time there
+ */
+inline float dev_time_minutes(const DevTimeTable& table, const DevTimeQuery& query) {
+    DevTimeSegment segment;
+    if(!dev_time_table::segment_at(table, query, segment)) {
+        return -1.0f;
+    }
+    return segment.at(dev_time_table::query_value(table.axes[0], query));
+}
+
+/**
+ * @brief Developer time against temperature for fixed push/pull, dilution
+ * and rolls, for following a drifting bath.
+ *
+ * Keeps the segment of the curve around the last temperature, so as long as
+ * the temperature stays between the same two grid points a lookup is one
+ * Hermite evaluation. Crossing a grid point reloads the segment from the
+ * table. Needs a table whose first axis is temperature.
+ */
+class DevTimeCurve {
+public:
+    // false if the table's first axis is not temperature
+    bool select(const DevTimeTable* table, const DevTimeQuery& query) {
+        this->table = table && table->axis_count > 0 &&
+                              table->axes[0].kind == DevTimeAxisKind::Temperature ?
+                          table :
+                          nullptr;
+        this->query = query;
+        loaded = false;
+        return this->table != nullptr;
+    }
+
+    /**
+     * @brief Minutes at a temperature in the table's unit
+     * @return A negative value if the table has no time there
+     */
+    float minutes_at(float temperature) {
+        if(!table) {
+            return -1.0f;
+        }
+        if(!loaded || !segment.covers(temperature)) {
+            query.temperature = temperature;
+            loaded = dev_time_table::segment_at(*table, query, segment);
+            if(!loaded) {
+                return -1.0f;
+            }
+        }
+        return segment.at(temperature);
+    }
+
+private:
+    const DevTimeTable* table{nullptr};
+    DevTimeQuery query{};
+    DevTimeSegment segment{};
+    bool loaded{false};
+};
+
+/**
+ * @brief Developer time in milliseconds
+ * @param push_pull -1 to +3 stops
+ * @param rolls Rolls developed with this chemistry, this one included
+ * @return The time in milliseconds, or a negative value if the table has no
+ * time for these settings
+ */
+inline float calculate_dev_time_ms(
+    const DevTimeTable& table,
+    float temp,
+    int push_pull,
+    int rolls) {
+    DevTimeQuery query{temp, static_cast<float>(push_pull), 0, static_cast<float>(rolls)};
+    float minutes = dev_time_minutes(table, query);
+    if(minutes < 0) {
+        return -1.0f;
+    }
+    FURI_LOG_D(
+        DEV_TIME_TAG,
+        "%.2f min at %.1f, push/pull %d, %d rolls",
+        static_cast<double>(minutes),
+        static_cast<double>(temp),
+        push_pull,
+        rolls);
+    return minutes * 60.0f * 1000.0f;
+}
+
+/**
+ * @brief Define NAME as the slopes of a table in flash, from the points of
+ * its first axis and its minutes
+ */
+#define DEV_TIME_SLOPES(NAME, POINTS, MINUTES) \
+    static constexpr auto NAME = dev_time_table::slopes(POINTS, MINUTES)
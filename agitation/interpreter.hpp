@@ -0,0 +1,612 @@
+#pragma once
+
+#include "agitation_pattern.hpp"
+#include "agitation_processes.hpp"
+#include "dev_time_table.hpp"
+#include "interpreter_policies.hpp"
+#include "process_interpreter_interface.hpp"
+#include "process_library.hpp"
+#include "../temperature_sensor.hpp"
+#include <furi.h>
+#include <string.h>
+
+#define TAG_INTERPRETER "Interpreter"
+
+/**
+ * @brief Runs any process of AGITATION_PROCESSES, or of a ProcessLibrary
+ * once one is set, statically dispatched.
+ *
+ * Processes are data: each step names a time model and a packed agitation
+ * sequence, and this one engine reads both. How long a step runs comes from
+ * its time model, computed once when the step starts or a setting changes:
+ * - AgitationTimeModelSequence: as long as the sequence, up to its first
+ *   top-level wait
+ * - AgitationTimeModelFixed: duration_ms
+ * - AgitationTimeModelDevTable: interpolated in dev_table for the
+ *   temperature, push/pull and roll count, and compensated for the measured
+ *   bath temperature while the step runs
+ * The motor direction is looked up in the sequence at the time into the
+ * step, see agitation_pattern.hpp. A sequence that ends before a fixed or
+ * table time repeats, and an empty one turns clockwise for the whole step.
+ *
+ * The clock, the motor and the trace are template parameters, so nothing in
+ * here is virtual. The device build runs on FuriClock and the final
+ * MotorControllerEmbedded, which turns every clock read and motor command
+ * into a direct call the compiler can inline. A host build can run the same
+ * code on VirtualClock and RecordingMotor and check a whole process in a
+ * loop. The app only sees InterpreterAdapter, the one place where the
+ * ProcessInterpreterInterface virtuals remain.
+ *
+ * Step time is measured on the clock instead of counting ticks, so it stays
+ * exact when the app ticks early (start, confirm, skip) or pauses mid-tick.
+ *
+ * Development is a rate that depends on temperature. With a probe feed, a
+ * table-timed step integrates its progress as the sum of dt / t_dev(T) over
+ * the ticks, T being the latest probe reading, and ends when the progress
+ * reaches one. The remaining time is projected at the current temperature,
+ * so a bath that drifts a degree moves the end of the step. Without a
+ * reading, T is the set temperature and the step lasts the tabulated time.
+ *
+ * @tparam Clock Provides uint32_t now_ms(), see FuriClock
+ * @tparam Motor A MotorController
+ * @tparam Trace Receives the hooks of NoTrace
+ */
+template<typename Clock, typename Motor, typename Trace = NoTrace>
+class Interpreter : public ProcessEventReporter {
+public:
+    // Entries of the same direction looked past for the next change
+    static constexpr size_t MAX_LOOKAHEAD = 8;
+
+    explicit Interpreter(Motor& motor, Clock clock = Clock(), Trace trace = Trace())
+        : motor(motor)
+        , clock(clock)
+        , trace(trace) {
+        loadProcess(0);
+    }
+
+    void init() {
+        reset();
+    }
+
+    bool tick() {
+        if(state != ProcessState::Running) {
+            FURI_LOG_T(TAG_INTERPRETER, "Ignoring tick, current state: %s", getStateName());
+            return false;
+        }
+
+        accumulateElapsedTime();
+        trace.onTick(clock.now_ms(), current_step_index, accumulated_time_ms);
+
+        if(accumulated_time_ms >= step_duration_ms) {
+            FURI_LOG_D(TAG_INTERPRETER, "Elapsed time >= duration, stopping motor");
+            drive(MotorController::Direction::Stopped);
+            if(step_confirms) {
+                setState(ProcessState::WaitingForUser);
+                emitEvent(ProcessEvent::Type::UserActionRequired);
+                return true;
+            }
+            advanceToNextStep();
+            return true;
+        }
+
+        // An empty sequence turns clockwise for the whole step, also after
+        // a pause stopped the motor
+        const PackedSequence& sequence = currentStep().sequence;
+        MotorController::Direction direction = MotorController::Direction::Clockwise;
+        if(sequence.length > 0) {
+            uint32_t at = pattern_ms != agitation_pattern::FOREVER && pattern_ms > 0 ?
+                              accumulated_time_ms % pattern_ms :
+                              accumulated_time_ms;
+            direction = agitation_pattern::direction_at(sequence, at);
+            if(direction != movement_direction) {
+                movement_direction = direction;
+                movement_started_ms = accumulated_time_ms;
+                movement_index++;
+                emitEvent(ProcessEvent::Type::MovementChanged, movement_index);
+            }
+        }
+        drive(direction);
+        return true;
+    }
+
+    void reset() {
+        FURI_LOG_D(TAG_INTERPRETER, "Resetting process");
+        current_step_index = 0;
+        setState(ProcessState::Idle);
+        accumulated_time_ms = 0;
+        progress = 0;
+        progress_error = 0;
+        movement_direction = MotorController::Direction::Stopped;
+        movement_started_ms = 0;
+        movement_index = 0;
+        drive(MotorController::Direction::Stopped);
+        timeCurrentStep();
+    }
+
+    void stop() {
+        FURI_LOG_I(TAG_INTERPRETER, "Stopping process");
+        reset();
+    }
+
+    void start() {
+        FURI_LOG_I(TAG_INTERPRETER, "Starting %s", process->process_name);
+        reset();
+        startStep();
+    }
+
+    void confirm() {
+        if(isWaitingForUser()) {
+            FURI_LOG_D(TAG_INTERPRETER, "Confirming user action");
+            advanceToNextStep();
+        } else {
+            FURI_LOG_W(TAG_INTERPRETER, "Not waiting for user, ignoring confirm");
+        }
+    }
+
+    void advanceToNextStep() {
+        if(current_step_index + 1 < process->steps_length) {
+            FURI_LOG_I(
+                TAG_INTERPRETER, "Advancing to step %u", (unsigned int)(current_step_index + 1));
+            current_step_index++;
+            startStep();
+        } else {
+            FURI_LOG_I(TAG_INTERPRETER, "Process complete");
+            drive(MotorController::Direction::Stopped);
+            setState(ProcessState::Complete);
+            emitEvent(ProcessEvent::Type::ProcessCompleted);
+        }
+    }
+
+    void restartCurrentStep() {
+        FURI_LOG_I(TAG_INTERPRETER, "Restarting current step");
+        startStep();
+    }
+
+    void pause() {
+        if(state == ProcessState::Running) {
+            FURI_LOG_D(TAG_INTERPRETER, "Pausing process");
+            // Credit the partial tick before the pause so it is not lost
+            accumulateElapsedTime();
+            drive(MotorController::Direction::Stopped);
+            setState(ProcessState::Paused);
+        } else {
+            FURI_LOG_W(TAG_INTERPRETER, "Ignoring pause, current state: %s", getStateName());
+        }
+    }
+
+    void resume() {
+        if(state == ProcessState::Paused) {
+            FURI_LOG_D(TAG_INTERPRETER, "Resuming process");
+            setState(ProcessState::Running);
+            last_tick_ms = clock.now_ms();
+            // The direction is a function of the step time, so the first
+            // tick picks it up where the pause left it
+            tick();
+        } else {
+            FURI_LOG_W(TAG_INTERPRETER, "Ignoring resume, current state: %s", getStateName());
+        }
+    }
+
+    // State information
+    bool isWaitingForUser() const {
+        return state == ProcessState::WaitingForUser;
+    }
+    bool isComplete() const {
+        return state == ProcessState::Complete;
+    }
+    ProcessState getState() const {
+        return state;
+    }
+    size_t getCurrentStepIndex() const {
+        return current_step_index;
+    }
+
+    const char* getUserMessage() const {
+        if(isComplete()) {
+            return "Process Complete";
+        }
+        if(current_step_index + 1 >= process->steps_length) {
+            return "Finish";
+        }
+        return process->steps[current_step_index + 1].name;
+    }
+
+    // Timing information
+    uint32_t getCurrentMovementTimeElapsed() const {
+        return accumulated_time_ms;
+    }
+
+    uint32_t getCurrentMovementTimeRemaining() const {
+        return accumulated_time_ms >= step_duration_ms ? 0 :
+                                                         step_duration_ms - accumulated_time_ms;
+    }
+
+    uint32_t getCurrentMovementDuration() const {
+        return step_duration_ms;
+    }
+
+    // Time the sequence has kept the motor turning the current way, or
+    // stopped, since the step started or the direction last changed
+    uint32_t getTimeInDirectionMs() const {
+        uint32_t since = state == ProcessState::Running ? clock.now_ms() - last_tick_ms : 0;
+        return accumulated_time_ms - movement_started_ms + since;
+    }
+
+    /**
+     * @brief Time from now until a tick would turn the motor another way or
+     * end the step, FOREVER while nothing is due. A compensated step's end
+     * moves with the bath, the app ticks at least every second anyway.
+     */
+    uint32_t getTimeToNextEventMs() const {
+        if(state != ProcessState::Running) {
+            return agitation_pattern::FOREVER;
+        }
+        uint32_t next = getCurrentMovementTimeRemaining();
+        uint32_t change = timeToDirectionChange();
+        if(change < next) {
+            next = change;
+        }
+        uint32_t since = clock.now_ms() - last_tick_ms;
+        return next == agitation_pattern::FOREVER ? next : next > since ? next - since : 0;
+    }
+
+    // Step information
+    const char* getCurrentStepName() const {
+        if(isComplete()) return "Complete";
+        return currentStep().name;
+    }
+
+    const char* getCurrentMovementName() const {
+        return motor.getDirectionString();
+    }
+
+    // Process list management
+    size_t getProcessCount() const {
+        return library ? library->get_count() : AGITATION_PROCESS_COUNT;
+    }
+
+    bool getProcessName(size_t index, char* buffer, size_t buffer_size) const {
+        if(library) {
+            return library->get_name(index, buffer, buffer_size);
+        }
+        if(index >= AGITATION_PROCESS_COUNT || !buffer || buffer_size == 0) {
+            return false;
+        }
+        const char* name = AGITATION_PROCESSES[index]->process_name;
+        if(strlen(name) >= buffer_size) {
+            return false;
+        }
+        strcpy(buffer, name);
+        return true;
+    }
+
+    bool selectProcess(const char* process_name) {
+        if(!process_name) {
+            return false;
+        }
+        size_t index = 0;
+        if(library) {
+            if(library->find(process_name, index)) {
+                return loadProcess(index);
+            }
+        } else {
+            for(; index < AGITATION_PROCESS_COUNT; index++) {
+                if(strcmp(AGITATION_PROCESSES[index]->process_name, process_name) == 0) {
+                    return loadProcess(index);
+                }
+            }
+        }
+        FURI_LOG_W(TAG_INTERPRETER, "No process named %s", process_name);
+        return false;
+    }
+
+    bool selectProcess(size_t index) {
+        if(index >= getProcessCount()) {
+            FURI_LOG_W(TAG_INTERPRETER, "No process %u", (unsigned int)index);
+            return false;
+        }
+        return loadProcess(index);
+    }
+
+    size_t getCurrentProcessIndex() const {
+        return process_index;
+    }
+
+    // Process parameters
+    void setProcessPushPull(int stops) {
+        FURI_LOG_D(TAG_INTERPRETER, "Setting push pull stops to %d", stops);
+        push_pull_stops = stops;
+        timeCurrentStep();
+    }
+    void setRolls(int count) {
+        FURI_LOG_D(TAG_INTERPRETER, "Setting roll count to %d", count);
+        roll_count = count;
+        timeCurrentStep();
+    }
+    void setTemperature(float temp) {
+        FURI_LOG_D(TAG_INTERPRETER, "Setting temperature to %f", static_cast<double>(temp));
+        temperature = temp;
+        timeCurrentStep();
+    }
+
+    int getProcessPushPull() const {
+        return push_pull_stops;
+    }
+    int getRolls() const {
+        return roll_count;
+    }
+    float getTemperature() const {
+        return temperature;
+    }
+
+    float getTargetCelsius() const {
+        return process && process->fahrenheit ? (temperature - 32.0f) / 1.8f : temperature;
+    }
+
+    // Processes to offer beyond the built-in ones, the library stays owned
+    // by the caller
+    void setProcessLibrary(ProcessLibrary* library) {
+        this->library = library;
+    }
+
+    void setTemperatureFeed(const TemperatureFeed* feed) {
+        temperature_feed = feed;
+        timeCurrentStep();
+    }
+
+    Clock& getClock() {
+        return clock;
+    }
+    Trace& getTrace() {
+        return trace;
+    }
+
+private:
+    const AgitationStepStatic& currentStep() const {
+        return process->steps[current_step_index];
+    }
+
+    // Selects a process with its default settings, idle at the first step
+    /**
+     * @brief false if the process cannot be read. A recipe that fails has
+     * already replaced the library's last one, so a current recipe gives
+     * way to the first built-in process.
+     */
+    bool loadProcess(size_t index) {
+        const AgitationProcessStatic* next = library ? library->load(index) :
+                                                       AGITATION_PROCESSES[index];
+        if(!next) {
+            FURI_LOG_E(TAG_INTERPRETER, "Cannot load process %u", (unsigned int)index);
+            if(process_index >= AGITATION_PROCESS_COUNT) {
+                loadProcess(0);
+            }
+            return false;
+        }
+        process_index = index;
+        process = next;
+        push_pull_stops = 0;
+        roll_count = 1;
+        temperature = process->temperature;
+        FURI_LOG_I(
+            TAG_INTERPRETER,
+            "Loaded %s, %u steps",
+            process->process_name,
+            (unsigned int)process->steps_length);
+        reset();
+        return true;
+    }
+
+    /**
+     * @brief Works out the duration of the current step from its time model.
+     * A table without a time for the settings leaves the process in Error.
+     */
+    void timeCurrentStep() {
+        const AgitationStepStatic& step = currentStep();
+        agitation_pattern::Timing timing = agitation_pattern::measure(step.sequence);
+        pattern_ms = timing.duration_ms;
+        step_confirms = step.requires_confirmation || timing.waits;
+        compensating = false;
+
+        switch(step.time_model) {
+        case AgitationTimeModelFixed:
+            step_duration_ms = step.duration_ms;
+            break;
+        case AgitationTimeModelDevTable: {
+            float duration_ms =
+                step.dev_table ?
+                    calculate_dev_time_ms(*step.dev_table, temperature, push_pull_stops, roll_count) :
+                    -1.0f;
+            if(duration_ms < 0) {
+                FURI_LOG_E(TAG_INTERPRETER, "No developer time for %s", step.name);
+                step_duration_ms = 0;
+                drive(MotorController::Direction::Stopped);
+                setState(ProcessState::Error);
+                return;
+            }
+            step_duration_ms = static_cast<uint32_t>(duration_ms);
+            DevTimeQuery query{
+                temperature,
+                static_cast<float>(push_pull_stops),
+                0,
+                static_cast<float>(roll_count)};
+            compensating = curve.select(step.dev_table, query);
+            if(compensating) {
+                // Project the rest of the step from the bath as it is now
+                compensate(0);
+            }
+            break;
+        }
+        default:
+            step_duration_ms = pattern_ms;
+            break;
+        }
+
+        // Settings that work again clear an earlier error
+        if(state == ProcessState::Error) {
+            setState(ProcessState::Idle);
+        }
+    }
+
+    /**
+     * @brief Time from the last tick until the sequence turns the motor
+     * another way, FOREVER if it never does. Entries that keep the
+     * direction are looked past, up to MAX_LOOKAHEAD of them.
+     */
+    uint32_t timeToDirectionChange() const {
+        const PackedSequence& sequence = currentStep().sequence;
+        if(sequence.length == 0) {
+            return agitation_pattern::FOREVER;
+        }
+        bool repeats = pattern_ms != agitation_pattern::FOREVER && pattern_ms > 0;
+        uint32_t at = repeats ? accumulated_time_ms % pattern_ms : accumulated_time_ms;
+        agitation_pattern::Position position = agitation_pattern::position_at(sequence, at);
+        MotorController::Direction direction = position.direction;
+        uint32_t total = 0;
+        for(size_t i = 0; i < MAX_LOOKAHEAD; i++) {
+            if(position.remaining_ms == agitation_pattern::FOREVER) {
+                return agitation_pattern::FOREVER;
+            }
+            total = agitation_pattern::saturating_add(total, position.remaining_ms);
+            at += position.remaining_ms;
+            if(repeats && at >= pattern_ms) {
+                at -= pattern_ms;
+            }
+            position = agitation_pattern::position_at(sequence, at);
+            if(position.direction != direction) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    // Adds the clock time since the previous tick to the step time
+    void accumulateElapsedTime() {
+        uint32_t now = clock.now_ms();
+        uint32_t elapsed = now - last_tick_ms;
+        accumulated_time_ms += elapsed;
+        last_tick_ms = now;
+        if(compensating) {
+            compensate(elapsed);
+        }
+    }
+
+    // Temperature of the bath in the unit of the step's table
+    float bathTemperature() const {
+        if(temperature_feed) {
+            TemperatureReading reading = temperature_feed->read();
+            if(reading.valid) {
+                return currentStep().dev_table->fahrenheit ? reading.celsius * 1.8f + 32.0f :
+                                                             reading.celsius;
+            }
+        }
+        return temperature;
+    }
+
+    /**
+     * @brief Credits elapsed_ms of development at the bath temperature and
+     * moves the end of the step to where the rest of it will take at that
+     * temperature. One curve evaluation, the curve only goes back to the
+     * table when the temperature crosses a grid point.
+     */
+    void compensate(uint32_t elapsed_ms) {
+        float minutes = curve.minutes_at(bathTemperature());
+        if(minutes <= 0) {
+            // Outside the table, develop at the set temperature's rate
+            minutes = curve.minutes_at(temperature);
+            if(minutes <= 0) {
+                return;
+            }
+        }
+        float develop_ms = minutes * 60.0f * 1000.0f;
+        // Compensated summation: thousands of tick increments would
+        // otherwise lose most of a second to float rounding
+        float increment = static_cast<float>(elapsed_ms) / develop_ms - progress_error;
+        float sum = progress + increment;
+        progress_error = (sum - progress) - increment;
+        progress = sum;
+        float remaining_ms = progress < 1.0f ? (1.0f - progress) * develop_ms : 0.0f;
+        step_duration_ms = accumulated_time_ms + static_cast<uint32_t>(remaining_ms + 0.5f);
+    }
+
+    // Runs the current step from its start
+    void startStep() {
+        accumulated_time_ms = 0;
+        progress = 0;
+        progress_error = 0;
+        last_tick_ms = clock.now_ms();
+        setState(ProcessState::Running);
+        timeCurrentStep();
+        if(state == ProcessState::Error) {
+            return;
+        }
+        trace.onStep(last_tick_ms, current_step_index);
+        emitEvent(ProcessEvent::Type::StepStarted, current_step_index);
+
+        const PackedSequence& sequence = currentStep().sequence;
+        movement_direction = sequence.length > 0 ? agitation_pattern::direction_at(sequence, 0) :
+                                                   MotorController::Direction::Clockwise;
+        movement_started_ms = 0;
+        movement_index = 0;
+        drive(movement_direction);
+    }
+
+    // Commands the motor only when the direction changes
+    void drive(MotorController::Direction direction) {
+        if(direction == motor.getDirection()) {
+            return;
+        }
+        switch(direction) {
+        case MotorController::Direction::Clockwise:
+            motor.clockwise(true);
+            break;
+        case MotorController::Direction::CounterClockwise:
+            motor.counterClockwise(true);
+            break;
+        default:
+            motor.stop();
+            break;
+        }
+        reportMotorDirection(motor.getDirection());
+    }
+
+    void setState(ProcessState next) {
+        state = next;
+        trace.onState(clock.now_ms(), next);
+    }
+
+    const char* getStateName() const {
+        return ProcessInterpreterInterface::get_process_state_name(state);
+    }
+
+    Motor& motor;
+    Clock clock;
+    Trace trace;
+    const AgitationProcessStatic* process{nullptr};
+    size_t process_index{0};
+    size_t current_step_index{0};
+    ProcessState state{ProcessState::Idle};
+    uint32_t accumulated_time_ms{0};
+    uint32_t last_tick_ms{0};
+    // Length of the current step, and of one pass through its sequence
+    uint32_t step_duration_ms{0};
+    uint32_t pattern_ms{0};
+    bool step_confirms{false};
+    // Direction of the sequence, which a pause does not change, when it
+    // started and how many changes the step has had
+    MotorController::Direction movement_direction{MotorController::Direction::Stopped};
+    uint32_t movement_started_ms{0};
+    uint32_t movement_index{0};
+
+    // Time-temperature compensation of the current step
+    const TemperatureFeed* temperature_feed{nullptr};
+    ProcessLibrary* library{nullptr};
+    DevTimeCurve curve;
+    // Fraction of the development done
+    float progress{0};
+    float progress_error{0};
+    bool compensating{false};
+
+    int push_pull_stops{0};
+    int roll_count{1};
+    float temperature{0};
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "process_interpreter_interface.hpp"
+#include <utility>
+
+/**
+ * @brief Exposes a statically dispatched core such as Interpreter through
+ * ProcessInterpreterInterface.
+ *
+ * The app and the views only know the interface, so this is where the
+ * virtual calls stop: each override is one direct call into the core, which
+ * inlines clock, motor and trace calls below it.
+ */
+template<typename Core>
+class InterpreterAdapter final : public ProcessInterpreterInterface {
+public:
+    template<typename... Args>
+    explicit InterpreterAdapter(Args&&... args)
+        : core(std::forward<Args>(args)...) {
+    }
+
+    // Process list management
+    size_t getProcessCount() const override {
+        return core.getProcessCount();
+    }
+    bool getProcessName(size_t index, char* buffer, size_t buffer_size) const override {
+        return core.getProcessName(index, buffer, buffer_size);
+    }
+    bool selectProcess(const char* process_name) override {
+        return core.selectProcess(process_name);
+    }
+    bool selectProcess(size_t index) override {
+        return core.selectProcess(index);
+    }
+    size_t getCurrentProcessIndex() const override {
+        return core.getCurrentProcessIndex();
+    }
+
+    // Core functionality
+    void init() override {
+        core.init();
+    }
+    bool tick() override {
+        return core.tick();
+    }
+    uint32_t getTimeToNextEventMs() const override {
+        return core.getTimeToNextEventMs();
+    }
+    uint32_t getTimeInDirectionMs() const override {
+        return core.getTimeInDirectionMs();
+    }
+    void reset() override {
+        core.reset();
+    }
+    void start() override {
+        core.start();
+    }
+    void stop() override {
+        core.stop();
+    }
+    void confirm() override {
+        core.confirm();
+    }
+
+    // Step management
+    void advanceToNextStep() override {
+        core.advanceToNextStep();
+    }
+    void restartCurrentStep() override {
+        core.restartCurrentStep();
+    }
+    size_t getCurrentStepIndex() const override {
+        return core.getCurrentStepIndex();
+    }
+
+    // State information
+    bool isWaitingForUser() const override {
+        return core.isWaitingForUser();
+    }
+    bool isComplete() const override {
+        return core.isComplete();
+    }
+    const char* getUserMessage() const override {
+        return core.getUserMessage();
+    }
+    ProcessState getState() const override {
+        return core.getState();
+    }
+
+    // Timing information
+    uint32_t getCurrentMovementTimeRemaining() const override {
+        return core.getCurrentMovementTimeRemaining();
+    }
+    uint32_t getCurrentMovementTimeElapsed() const override {
+        return core.getCurrentMovementTimeElapsed();
+    }
+    uint32_t getCurrentMovementDuration() const override {
+        return core.getCurrentMovementDuration();
+    }
+
+    // Step information
+    const char* getCurrentStepName() const override {
+        return core.getCurrentStepName();
+    }
+    const char* getCurrentMovementName() const override {
+        return core.getCurrentMovementName();
+    }
+
+    // Process parameters
+    void setProcessPushPull(int stops) override {
+        core.setProcessPushPull(stops);
+    }
+    void setRolls(int count) override {
+        core.setRolls(count);
+    }
+    void setTemperature(float temp) override {
+        core.setTemperature(temp);
+    }
+    int getProcessPushPull() const override {
+        return core.getProcessPushPull();
+    }
+    int getRolls() const override {
+        return core.getRolls();
+    }
+    float getTemperature() const override {
+        return core.getTemperature();
+    }
+    float getTargetCelsius() const override {
+        return core.getTargetCelsius();
+    }
+    void setTemperatureFeed(const TemperatureFeed* feed) override {
+        core.setTemperatureFeed(feed);
+    }
+    void setProcessLibrary(ProcessLibrary* library) override {
+        core.setProcessLibrary(library);
+    }
+
+    void pause() override {
+        core.pause();
+    }
+    void resume() override {
+        core.resume();
+    }
+
+    void setEventQueue(ProcessEventQueue* queue) override {
+        core.setEventQueue(queue);
+    }
+
+    Core& getCore() {
+        return core;
+    }
+
+private:
+    Core core;
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include "../motor_controller.hpp"
+#include "process_interpreter_interface.hpp"
+#include <furi.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define TAG_INTERPRETER_TRACE "InterpreterTrace"
+
+/**
+ * @brief Policies plugged into Interpreter at compile time.
+ *
+ * A clock provides now_ms(). A motor is any MotorController; a final one
+ * lets the compiler call it directly. A trace receives onTick(), onStep()
+ * and onState() with the clock's time, and NoTrace compiles them away.
+ */
+
+// Kernel tick counter, the time base of the device build
+struct FuriClock {
+    uint32_t now_ms() const {
+        return furi_get_tick();
+    }
+};
+
+// Time that only moves when told to, so a host run can skip through a
+// process in as many ticks as it needs
+class VirtualClock {
+public:
+    uint32_t now_ms() const {
+        return now;
+    }
+
+    void advance(uint32_t ms) {
+        now += ms;
+    }
+
+private:
+    uint32_t now{0};
+};
+
+struct NoTrace {
+    void onTick(uint32_t, size_t, uint32_t) {
+    }
+    void onStep(uint32_t, size_t) {
+    }
+    void onState(uint32_t, ProcessState) {
+    }
+};
+
+// Logs every hook, for following a process on the host
+struct LogTrace {
+    void onTick(uint32_t now_ms, size_t step, uint32_t elapsed_ms) {
+        FURI_LOG_D(
+            TAG_INTERPRETER_TRACE,
+            "%lu ms: step %u at %lu ms",
+            (unsigned long)now_ms,
+            (unsigned int)step,
+            (unsigned long)elapsed_ms);
+    }
+    void onStep(uint32_t now_ms, size_t step) {
+        FURI_LOG_D(
+            TAG_INTERPRETER_TRACE,
+            "%lu ms: step %u started",
+            (unsigned long)now_ms,
+            (unsigned int)step);
+    }
+    void onState(uint32_t now_ms, ProcessState state) {
+        FURI_LOG_D(
+            TAG_INTERPRETER_TRACE,
+            "%lu ms: %s",
+            (unsigned long)now_ms,
+            ProcessInterpreterInterface::get_process_state_name(state));
+    }
+};
+
+/**
+ * @brief Motor without hardware that remembers the directions it was driven
+ * in, in order. Repeated commands in the same direction are kept once.
+ */
+class RecordingMotor final : public MotorController {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+    void clockwise(bool enable) override {
+        drive(enable ? Direction::Clockwise : Direction::Stopped);
+    }
+    void counterClockwise(bool enable) override {
+        drive(enable ? Direction::CounterClockwise : Direction::Stopped);
+    }
+    void stop() override {
+        drive(Direction::Stopped);
+    }
+    bool isRunning() const override {
+        return current != Direction::Stopped;
+    }
+    bool isClockwise() const override {
+        return current == Direction::Clockwise;
+    }
+    bool isCounterClockwise() const override {
+        return current == Direction::CounterClockwise;
+    }
+    bool isStopped() const override {
+        return current == Direction::Stopped;
+    }
+    const char* getDirectionString() const override {
+        switch(current) {
+        case Direction::Clockwise:
+            return "CW";
+        case Direction::CounterClockwise:
+            return "CCW";
+        default:
+            return "Idle";
+        }
+    }
+
+    size_t getCount() const {
+        return count;
+    }
+    Direction get(size_t index) const {
+        return history[index];
+    }
+    // Changes that did not fit the history
+    size_t getDropped() const {
+        return dropped;
+    }
+    void clear() {
+        count = 0;
+        dropped = 0;
+    }
+
+private:
+    void drive(Direction direction) {
+        if(direction == current) {
+            return;
+        }
+        current = direction;
+        if(count == CAPACITY) {
+            dropped++;
+            return;
+        }
+        history[count++] = direction;
+    }
+
+    Direction current{Direction::Stopped};
+    Direction history[CAPACITY]{};
+    size_t count{0};
+    size_t dropped{0};
+};
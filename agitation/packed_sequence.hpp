@@ -0,0 +1,184 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include "agitation_sequence.hpp"
+
+/**
+ * @brief Compact flash encoding of agitation sequences.
+ *
+ * Processes are still written as AgitationMovementStatic with designated
+ * initializers, then packed at compile time with AGITATION_PACKED_SEQUENCE.
+ * Only the packed words end up in the binary. Each movement is one 32-bit
+ * word:
+ *
+ *   CW, CCW, pause, wait  | type:3 | duration:29 |
+ *   loop                  | type:3 | limited:1 | length:6 | offset:10 | count:12 |
+ *
+ * Durations are in milliseconds, so 29 bits cover about 149 hours.
+ * A loop's body is stored later in the same array, offset words after the
+ * loop. If the loop has a max_duration it follows as one extra word, and
+ * limited is set. Wait messages are not kept, nothing reads them.
+ *
+ * The interpreter runs straight from the packed words, see
+ * agitation_pattern.hpp.
+ */
+namespace packed_sequence {
+
+constexpr uint32_t TYPE_SHIFT = 29;
+constexpr uint32_t DURATION_MASK = (1u << TYPE_SHIFT) - 1;
+
+constexpr uint32_t LIMITED_BIT = 1u << 28;
+constexpr uint32_t LENGTH_SHIFT = 22;
+constexpr uint32_t LENGTH_MASK = 0x3F;
+constexpr uint32_t OFFSET_SHIFT = 12;
+constexpr uint32_t OFFSET_MASK = 0x3FF;
+constexpr uint32_t COUNT_MASK = 0xFFF;
+
+enum class PackError {
+    None,
+    DurationTooLong,
+    LoopCountTooLarge,
+    LoopTooLong,
+    BodyTooFar,
+    TooManyWords,
+};
+
+// Not constexpr: reaching one while encoding stops the build
+void duration_does_not_fit_29_bits();
+void loop_count_does_not_fit_12_bits();
+void loop_length_does_not_fit_6_bits();
+void loop_body_too_far_from_loop();
+
+constexpr size_t entry_words(const AgitationMovementStatic& movement) {
+    return movement.type == AgitationMovementTypeLoop && movement.loop.max_duration > 0 ? 2 : 1;
+}
+
+constexpr size_t entry_words(uint32_t word) {
+    return (word >> TYPE_SHIFT) == AgitationMovementTypeLoop && (word & LIMITED_BIT) ? 2 : 1;
+}
+
+// Words taken by a sequence and all the loop bodies below it
+constexpr size_t encoded_size(const AgitationMovementStatic* sequence, size_t length) {
+    size_t words = 0;
+    for(size_t i = 0; i < length; i++) {
+        words += entry_words(sequence[i]);
+        if(sequence[i].type == AgitationMovementTypeLoop) {
+            words += encoded_size(sequence[i].loop.sequence, sequence[i].loop.sequence_length);
+        }
+    }
+    return words;
+}
+
+/**
+ * @brief Pack a sequence into words, at compile time through encode() or
+ * at run time for sequences read from a file. Bodies are laid out breadth
+ * first, each after everything already placed, so a body always follows
+ * its loop.
+ * @param source Scratch space for capacity pointers
+ * @param used Set to the number of words written
+ */
+constexpr PackError pack(
+    const AgitationMovementStatic* sequence,
+    size_t length,
+    uint32_t* words,
+    const AgitationMovementStatic** source,
+    size_t capacity,
+    size_t& used) {
+    size_t end = 0;
+    for(size_t i = 0; i < length; i++) {
+        if(end + entry_words(sequence[i]) > capacity) {
+            return PackError::TooManyWords;
+        }
+        source[end] = &sequence[i];
+        end += entry_words(sequence[i]);
+    }
+
+    for(size_t at = 0; at < end; at += entry_words(*source[at])) {
+        const AgitationMovementStatic& movement = *source[at];
+        uint32_t type = static_cast<uint32_t>(movement.type) << TYPE_SHIFT;
+
+        if(movement.type != AgitationMovementTypeLoop) {
+            uint32_t duration =
+                movement.type == AgitationMovementTypeWaitUser ? 0 : movement.duration;
+            if(duration > DURATION_MASK) {
+                return PackError::DurationTooLong;
+            }
+            words[at] = type | duration;
+            continue;
+        }
+
+        size_t offset = end - at;
+        if(movement.loop.count > COUNT_MASK) {
+            return PackError::LoopCountTooLarge;
+        }
+        if(movement.loop.sequence_length > LENGTH_MASK) {
+            return PackError::LoopTooLong;
+        }
+        if(offset > OFFSET_MASK) {
+            return PackError::BodyTooFar;
+        }
+        words[at] = type | (movement.loop.max_duration > 0 ? LIMITED_BIT : 0) |
+                    static_cast<uint32_t>(movement.loop.sequence_length) << LENGTH_SHIFT |
+                    static_cast<uint32_t>(offset) << OFFSET_SHIFT | movement.loop.count;
+        if(movement.loop.max_duration > 0) {
+            words[at + 1] = movement.loop.max_duration;
+        }
+
+        for(size_t i = 0; i < movement.loop.sequence_length; i++) {
+            if(end + entry_words(movement.loop.sequence[i]) > capacity) {
+                return PackError::TooManyWords;
+            }
+            source[end] = &movement.loop.sequence[i];
+            end += entry_words(movement.loop.sequence[i]);
+        }
+    }
+    used = end;
+    return PackError::None;
+}
+
+/**
+ * @brief Pack a sequence at compile time
+ * @tparam Words encoded_size() of the sequence
+ */
+template <size_t Words>
+constexpr std::array<uint32_t, Words>
+    encode(const AgitationMovementStatic* sequence, size_t length) {
+    std::array<uint32_t, Words> words{};
+    const AgitationMovementStatic* source[Words]{};
+    size_t used = 0;
+    switch(pack(sequence, length, words.data(), source, Words, used)) {
+    case PackError::DurationTooLong:
+        duration_does_not_fit_29_bits();
+        break;
+    case PackError::LoopCountTooLarge:
+        loop_count_does_not_fit_12_bits();
+        break;
+    case PackError::LoopTooLong:
+        loop_length_does_not_fit_6_bits();
+        break;
+    case PackError::BodyTooFar:
+        loop_body_too_far_from_loop();
+        break;
+    default:
+        break;
+    }
+    return words;
+}
+
+template <size_t Length>
+constexpr size_t length_of(const AgitationMovementStatic (&)[Length]) {
+    return Length;
+}
+
+} // namespace packed_sequence
+
+/**
+ * @brief Define NAME as the PackedSequence of the constexpr array SOURCE
+ */
+#define AGITATION_PACKED_SEQUENCE(NAME, SOURCE)                                              \
+    static constexpr auto NAME##_WORDS =                                                     \
+        packed_sequence::encode<packed_sequence::encoded_size(                              \
+            SOURCE, packed_sequence::length_of(SOURCE))>(SOURCE, packed_sequence::length_of(SOURCE)); \
+    static constexpr PackedSequence NAME = {NAME##_WORDS.data(), packed_sequence::length_of(SOURCE)}
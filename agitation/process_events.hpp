@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Notification pushed by a process interpreter when its observable
+ * state changes.
+ *
+ * The meaning of value depends on the type:
+ * - StepStarted: index of the step that started
+ * - MovementChanged: how many times the agitation changed direction in
+ *   the current step, counting this one
+ * - MotorDirectionChanged: the new MotorController::Direction
+ * - UserActionRequired, ProcessCompleted: unused
+ */
+struct ProcessEvent {
+    enum class Type : uint8_t {
+        StepStarted,
+        MovementChanged,
+        UserActionRequired,
+        ProcessCompleted,
+        MotorDirectionChanged,
+    };
+
+    Type type;
+    uint32_t value;
+
+    static const char* get_type_name(Type type) {
+        switch(type) {
+        case Type::StepStarted:
+            return "StepStarted";
+        case Type::MovementChanged:
+            return "MovementChanged";
+        case Type::UserActionRequired:
+            return "UserActionRequired";
+        case Type::ProcessCompleted:
+            return "ProcessCompleted";
+        case Type::MotorDirectionChanged:
+            return "MotorDirectionChanged";
+        }
+        return "Unknown";
+    }
+};
+
+/**
+ * @brief Bounded FIFO of process events, drained once per app wakeup.
+ *
+ * The interpreter and the app both run on the view dispatcher thread, so the
+ * queue needs no locking. When it is full the newest event is dropped and
+ * counted; a tick produces only a handful of events, so this only happens if
+ * the app stops draining.
+ */
+class ProcessEventQueue {
+public:
+    static constexpr size_t CAPACITY = 16;
+
+    bool push(ProcessEvent::Type type, uint32_t value = 0) {
+        if(count == CAPACITY) {
+            dropped++;
+            return false;
+        }
+        events[(head + count) % CAPACITY] = {type, value};
+        count++;
+        return true;
+    }
+
+    bool pop(ProcessEvent& event) {
+        if(count == 0) {
+            return false;
+        }
+        event = events[head];
+        head = (head + 1) % CAPACITY;
+        count--;
+        return true;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    void clear() {
+        head = 0;
+        count = 0;
+    }
+
+    size_t get_dropped_count() const {
+        return dropped;
+    }
+
+private:
+    ProcessEvent events[CAPACITY]{};
+    size_t head{0};
+    size_t count{0};
+    size_t dropped{0};
+};
@@ -1,8 +1,44 @@
 #pragma once
 
+#include "../motor_controller.hpp"
+#include "process_events.hpp"
 #include <stddef.h>
 #include <stdint.h>
 
+class ProcessLibrary;
+class TemperatureFeed;
+
+/**
+ * @brief Pushes an interpreter's events into the app's queue
+ */
+class ProcessEventReporter {
+public:
+    void setEventQueue(ProcessEventQueue* queue) {
+        event_queue = queue;
+    }
+
+    void emitEvent(ProcessEvent::Type type, uint32_t value = 0) {
+        if(event_queue) {
+            event_queue->push(type, value);
+        }
+    }
+
+    // Emits MotorDirectionChanged only when the direction differs from the
+    // last one reported, so interpreters can call this after every motor
+    // command without flooding the queue.
+    void reportMotorDirection(MotorController::Direction direction) {
+        if(direction != reported_direction) {
+            reported_direction = direction;
+            emitEvent(
+                ProcessEvent::Type::MotorDirectionChanged, static_cast<uint32_t>(direction));
+        }
+    }
+
+private:
+    ProcessEventQueue* event_queue{nullptr};
+    MotorController::Direction reported_direction{MotorController::Direction::Stopped};
+};
+
 enum class ProcessState {
     Idle,
     Running,
@@ -31,14 +67,15 @@ enum class ProcessState {
  * ```
  *
  * ## Main Development Loop
- * The main development loop calls tick() periodically to advance the process:
+ * The app hands the interpreter its queue once, then after each tick()
+ * drains the events the interpreter pushed instead of polling its state:
  * ```cpp
+ * // In the FilmDeveloperApp constructor
+ * process_interpreter->setEventQueue(&process_events);
+ *
  * // In FilmDeveloperApp::update()
- * bool still_active = process_interpreter->tick();
- * model->update_status(
- *     process_interpreter->getCurrentMovementTimeElapsed(),
- *     process_interpreter->getCurrentMovementDuration()
- * );
+ * process_interpreter->tick();
+ * drain_process_events(model); // pops process_events until it is empty
  * ```
  *
  * ## Main Development View
@@ -69,13 +106,14 @@ enum class ProcessState {
  * ## Process Parameters
  * - Push/Pull: Adjusts development times by stops (-2 to +2)
  * - Roll Count: Number of rolls being developed (affects agitation)
- * - Temperature: Process temperature in Celsius
+ * - Temperature: Process temperature, in Fahrenheit for processes so marked
  *
  * ## State Management
  * The interpreter maintains the process state (Idle, Running, Complete, Error)
  * and handles transitions between steps and movements within steps.
  *
- * @see AgitationProcessInterpreter for the concrete implementation
+ * @see Interpreter for the statically dispatched core the app runs, and
+ * InterpreterAdapter for how it is exposed through this interface
  * @see MainViewModel for the model layer integration
  * @see SettingsView for the settings UI
  */
@@ -105,11 +143,19 @@ public:
     virtual size_t getProcessCount() const = 0;
     virtual bool getProcessName(size_t index, char* buffer, size_t buffer_size) const = 0;
     virtual bool selectProcess(const char* process_name) = 0;
+    // By position in the list, which tells apart processes of the same name
+    virtual bool selectProcess(size_t index) = 0;
     virtual size_t getCurrentProcessIndex() const = 0;
 
     // Core functionality
     virtual void init() = 0;
     virtual bool tick() = 0;
+    // How long the app may wait before tick() changes the motor or ends the
+    // step, in milliseconds, UINT32_MAX while nothing is due
+    virtual uint32_t getTimeToNextEventMs() const = 0;
+    // How long the motor has turned the current way, or stood still, as the
+    // agitation asks, in milliseconds
+    virtual uint32_t getTimeInDirectionMs() const = 0;
     virtual void reset() = 0;
     virtual void start() = 0;
     virtual void stop() = 0;
@@ -143,8 +189,20 @@ public:
     virtual int getProcessPushPull() const = 0;
     virtual int getRolls() const = 0;
     virtual float getTemperature() const = 0;
+    // The set temperature in Celsius, whichever unit the process uses
+    virtual float getTargetCelsius() const = 0;
+
+    // Probe readings that compensate development time for the actual bath
+    // temperature, nullptr to time by the set temperature alone
+    virtual void setTemperatureFeed(const TemperatureFeed* feed) = 0;
+
+    // Recipes from the SD card, listed after the built-in processes
+    virtual void setProcessLibrary(ProcessLibrary* library) = 0;
 
     // Add new methods for pause/resume
     virtual void pause() = 0;
     virtual void resume() = 0;
+
+    // Queue receiving the interpreter's state change events, owned by the app
+    virtual void setEventQueue(ProcessEventQueue* queue) = 0;
 };
@@ -0,0 +1,541 @@
+#pragma once
+
+#include "agitation_pattern.hpp"
+#include "agitation_processes.hpp"
+#include "dev_time_table.hpp"
+#include "process_loader.hpp"
+#include <furi.h>
+#include <stdio.h>
+#include <string.h>
+#include <storage/storage.h>
+
+#define PROCESS_LIBRARY_TAG "ProcessLibrary"
+
+/**
+ * @brief What a process list shows of a process, without loading it
+ */
+struct ProcessSummary {
+    char name[LoadedProcess::MAX_TEXT];
+    char film[LoadedProcess::MAX_TEXT];
+    char chemistry[LoadedProcess::MAX_TEXT];
+    // Total of the steps at the process temperature, no push/pull and one
+    // roll. FOREVER if a step never ends on its own
+    uint32_t duration_ms;
+    uint8_t step_count;
+};
+
+/**
+ * @brief The built-in processes followed by the recipes on the SD card.
+ *
+ * Parsing hundreds of recipes at every launch would keep the selection
+ * menu waiting, so the library keeps an index file next to them: a fixed
+ * size record of each recipe's summary, file name, size and modification
+ * time, followed by two open addressing hash tables, of the process names
+ * and of the file names.
+ * ```
+ * | header | record 0 | ... | name bucket 0 | ... | file bucket 0 | ... |
+ * ```
+ * A bucket holds a record number plus one, 0 when empty. Records sit at
+ * fixed offsets, so entry i or a name lookup costs a seek and a read or
+ * two whatever the size of the library, and only the header is kept in
+ * memory.
+ *
+ * open() lists the recipes and compares their sizes and times with the
+ * index. The index is only rewritten if something changed, and then only
+ * new or changed recipes are parsed, the others keep their records, found
+ * by file name in the old index. A recipe that does not parse is still
+ * listed, by its file name, with no steps and the line of the error in
+ * place of the film, so it isn't parsed again until it changes. Recipes
+ * whose file name is MAX_FILE_NAME characters or longer, and any beyond
+ * MAX_RECIPES, are left out.
+ *
+ * Entries 0 to AGITATION_PROCESS_COUNT - 1 are the built-in processes, the
+ * recipes follow in directory order. The object holds a LoadedProcess, the
+ * recipe last loaded, and is several kilobytes: keep it static.
+ *
+ * Every call seeks the one index file and reuses the scratch record, even
+ * the const looking ones, so the library is used from a single thread. In
+ * the app that is the dispatcher thread; views drawing on the GUI thread
+ * get names from the model instead.
+ */
+class ProcessLibrary {
+public:
+    // In the app's data folder, created on first use
+    static constexpr const char* DIRECTORY = APP_DATA_PATH("processes");
+    static constexpr const char* EXTENSION = ".fdp";
+    static constexpr size_t MAX_RECIPES = 1024;
+
+    ProcessLibrary() {
+        for(size_t i = 0; i < AGITATION_PROCESS_COUNT; i++) {
+            builtin_hashes[i] = hash_name(AGITATION_PROCESSES[i]->process_name);
+        }
+    }
+
+    ~ProcessLibrary() {
+        close();
+    }
+
+    ProcessLibrary(const ProcessLibrary&) = delete;
+    ProcessLibrary& operator=(const ProcessLibrary&) = delete;
+
+    /**
+     * @brief Brings the index up to date with the recipes and opens it
+     * @return false if the index cannot be written, only the built-in
+     * processes are available then
+     */
+    bool open(Storage* storage) {
+        close();
+        this->storage = storage;
+        storage_simply_mkdir(storage, DIRECTORY);
+        index = storage_file_alloc(storage);
+        bool current = read_header();
+        if(current && matches_directory()) {
+            FURI_LOG_I(
+                PROCESS_LIBRARY_TAG, "%lu recipes, index current", (unsigned long)header.count);
+            return true;
+        }
+        if(!rebuild(current)) {
+            header = IndexHeader{};
+            return false;
+        }
+        return read_header();
+    }
+
+    void close() {
+        if(index) {
+            // Closes the file if open
+            storage_file_free(index);
+            index = nullptr;
+        }
+        header = IndexHeader{};
+    }
+
+    size_t get_count() const {
+        return AGITATION_PROCESS_COUNT + header.count;
+    }
+
+    bool get_summary(size_t entry, ProcessSummary& summary) {
+        if(entry < AGITATION_PROCESS_COUNT) {
+            summarize(*AGITATION_PROCESSES[entry], summary);
+            return true;
+        }
+        if(!read_record(entry - AGITATION_PROCESS_COUNT, record)) {
+            return false;
+        }
+        summary = record.summary;
+        return true;
+    }
+
+    /**
+     * @brief Calls visit(entry, summary) for the entries first to last - 1,
+     * in order, reading the records front to back instead of seeking to
+     * each one. Stops early if the index cannot be read.
+     */
+    template <typename Visit>
+    void for_each_summary(size_t first, size_t last, Visit visit) {
+        if(last > get_count()) {
+            last = get_count();
+        }
+        size_t entry = first;
+        for(; entry < last && entry < AGITATION_PROCESS_COUNT; entry++) {
+            summarize(*AGITATION_PROCESSES[entry], record.summary);
+            visit(entry, static_cast<const ProcessSummary&>(record.summary));
+        }
+        if(entry >= last ||
+           !storage_file_seek(index, record_offset(entry - AGITATION_PROCESS_COUNT), true)) {
+            return;
+        }
+        for(; entry < last; entry++) {
+            if(storage_file_read(index, &record, sizeof(record)) != sizeof(record)) {
+                return;
+            }
+            visit(entry, static_cast<const ProcessSummary&>(record.summary));
+        }
+    }
+
+    // false if there is no such entry or the name does not fit
+    bool get_name(size_t entry, char* buffer, size_t buffer_size) {
+        const char* name = nullptr;
+        if(entry < AGITATION_PROCESS_COUNT) {
+            name = AGITATION_PROCESSES[entry]->process_name;
+        } else if(read_record(entry - AGITATION_PROCESS_COUNT, record)) {
+            name = record.summary.name;
+        }
+        if(!name || !buffer || strlen(name) >= buffer_size) {
+            return false;
+        }
+        strcpy(buffer, name);
+        return true;
+    }
+
+    /**
+     * @brief Entry of the process with exactly this name, built-in ones
+     * first
+     */
+    bool find(const char* name, size_t& entry) {
+        uint32_t hash = hash_name(name);
+        for(size_t i = 0; i < AGITATION_PROCESS_COUNT; i++) {
+            if(builtin_hashes[i] == hash && strcmp(AGITATION_PROCESSES[i]->process_name, name) == 0) {
+                entry = i;
+                return true;
+            }
+        }
+        for(uint32_t probe = 0; probe < header.bucket_count; probe++) {
+            uint16_t bucket = 0;
+            if(!read_bucket(
+                   index, header, NAME_TABLE, (hash + probe) & (header.bucket_count - 1), bucket) ||
+               bucket == 0) {
+                return false;
+            }
+            if(read_record(bucket - 1, record) && record.name_hash == hash &&
+               strcmp(record.summary.name, name) == 0) {
+                entry = AGITATION_PROCESS_COUNT + bucket - 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief The process of an entry, read from its recipe if not built in.
+     * A recipe stays valid until the next load().
+     */
+    const AgitationProcessStatic* load(size_t entry) {
+        if(entry < AGITATION_PROCESS_COUNT) {
+            return AGITATION_PROCESSES[entry];
+        }
+        if(!read_record(entry - AGITATION_PROCESS_COUNT, record) || !recipe_path(record.file) ||
+           !loaded.load(storage, path)) {
+            return nullptr;
+        }
+        return loaded.get();
+    }
+
+    // FNV-1a
+    static uint32_t hash_name(const char* name) {
+        uint32_t hash = 2166136261u;
+        for(; *name; name++) {
+            hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+        }
+        return hash;
+    }
+
+    static void summarize(const AgitationProcessStatic& process, ProcessSummary& summary) {
+        snprintf(summary.name, sizeof(summary.name), "%s", process.process_name);
+        snprintf(summary.film, sizeof(summary.film), "%s", process.film_type);
+        snprintf(summary.chemistry, sizeof(summary.chemistry), "%s", process.chemistry);
+        summary.step_count = static_cast<uint8_t>(process.steps_length);
+        summary.duration_ms = 0;
+        for(size_t i = 0; i < process.steps_length; i++) {
+            summary.duration_ms =
+                agitation_pattern::saturating_add(summary.duration_ms, step_duration_ms(process, i));
+        }
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x49504446; // "FDPI"
+    static constexpr uint16_t VERSION = 2;
+    // Hash tables after the records, each bucket_count buckets long
+    static constexpr uint32_t NAME_TABLE = 0;
+    static constexpr uint32_t FILE_TABLE = 1;
+    static constexpr const char* INDEX_NAME = ".index";
+    static constexpr const char* REBUILT_NAME = ".index.new";
+    static constexpr size_t MAX_FILE_NAME = 32;
+
+    struct IndexHeader {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t record_size;
+        uint32_t count;
+        uint32_t bucket_count; // A power of two, at least twice the count
+    };
+
+    struct IndexRecord {
+        uint32_t name_hash;
+        uint32_t file_hash;
+        uint32_t modified;
+        uint32_t size;
+        char file[MAX_FILE_NAME];
+        ProcessSummary summary;
+    };
+    // A recipe that does not parse is listed by its file name
+    static_assert(MAX_FILE_NAME <= LoadedProcess::MAX_TEXT, "File names do not fit a summary");
+
+    static uint32_t step_duration_ms(const AgitationProcessStatic& process, size_t index) {
+        const AgitationStepStatic& step = process.steps[index];
+        switch(step.time_model) {
+        case AgitationTimeModelFixed:
+            return step.duration_ms;
+        case AgitationTimeModelDevTable: {
+            float duration_ms =
+                step.dev_table ? calculate_dev_time_ms(*step.dev_table, process.temperature, 0, 1) :
+                                 -1.0f;
+            return duration_ms > 0 ? static_cast<uint32_t>(duration_ms) : 0;
+        }
+        default:
+            return agitation_pattern::measure(step.sequence).duration_ms;
+        }
+    }
+
+    static uint32_t record_offset(uint32_t number) {
+        return sizeof(IndexHeader) + number * sizeof(IndexRecord);
+    }
+
+    static uint32_t
+        bucket_offset(const IndexHeader& header, uint32_t table, uint32_t bucket) {
+        return record_offset(header.count) +
+               (table * header.bucket_count + bucket) * sizeof(uint16_t);
+    }
+
+    static bool read_bucket(
+        File* file,
+        const IndexHeader& header,
+        uint32_t table,
+        uint32_t bucket,
+        uint16_t& value) {
+        return storage_file_seek(file, bucket_offset(header, table, bucket), true) &&
+               storage_file_read(file, &value, sizeof(value)) == sizeof(value);
+    }
+
+    // A recipe with a file name that fits its record. Both listing the
+    // directory and writing the index go by this, with the MAX_RECIPES cap.
+    static bool is_indexable(const FileInfo& info, const char* name) {
+        size_t length = strlen(name);
+        size_t extension = strlen(EXTENSION);
+        return !file_info_is_dir(&info) && name[0] != '.' && length > extension &&
+               length < MAX_FILE_NAME && strcmp(name + length - extension, EXTENSION) == 0;
+    }
+
+    bool recipe_path(const char* file_name) {
+        int written = snprintf(path, sizeof(path), "%s/%s", DIRECTORY, file_name);
+        return written > 0 && static_cast<size_t>(written) < sizeof(path);
+    }
+
+    uint32_t modified_time(const char* file_name) {
+        uint32_t timestamp = 0;
+        if(!recipe_path(file_name) ||
+           storage_common_timestamp(storage, path, &timestamp) != FSE_OK) {
+            return 0;
+        }
+        return timestamp;
+    }
+
+    // Opens the index and checks its header
+    bool read_header() {
+        header = IndexHeader{};
+        if(storage_file_is_open(index)) {
+            storage_file_close(index);
+        }
+        snprintf(path, sizeof(path), "%s/%s", DIRECTORY, INDEX_NAME);
+        IndexHeader read{};
+        if(!storage_file_open(index, path, FSAM_READ, FSOM_OPEN_EXISTING) ||
+           storage_file_read(index, &read, sizeof(read)) != sizeof(read) || read.magic != MAGIC ||
+           read.version != VERSION || read.record_size != sizeof(IndexRecord) ||
+           read.count > MAX_RECIPES) {
+            return false;
+        }
+        header = read;
+        return true;
+    }
+
+    bool read_record(uint32_t number, IndexRecord& into) {
+        return number < header.count && storage_file_seek(index, record_offset(number), true) &&
+               storage_file_read(index, &into, sizeof(into)) == sizeof(into);
+    }
+
+    // Whether the recipes are those indexed, in the same order, unchanged
+    bool matches_directory() {
+        File* directory = storage_file_alloc(storage);
+        bool matches = storage_dir_open(directory, DIRECTORY);
+        uint32_t number = 0;
+        FileInfo info;
+        while(matches && number < MAX_RECIPES &&
+              storage_dir_read(directory, &info, file_name, sizeof(file_name))) {
+            if(!is_indexable(info, file_name)) {
+                continue;
+            }
+            matches = read_record(number++, record) && strcmp(record.file, file_name) == 0 &&
+                      record.size == info.size && record.modified == modified_time(file_name);
+        }
+        storage_dir_close(directory);
+        storage_file_free(directory);
+        return matches && number == header.count;
+    }
+
+    /**
+     * @brief Finds a recipe's record in the current index, first where it
+     * was in the directory listing, which rarely changes, then through the
+     * file name table
+     */
+    bool find_previous(const char* name, uint32_t hint, IndexRecord& into) {
+        if(read_record(hint, into) && strcmp(into.file, name) == 0) {
+            return true;
+        }
+        uint32_t hash = hash_name(name);
+        for(uint32_t probe = 0; probe < header.bucket_count; probe++) {
+            uint16_t bucket = 0;
+            if(!read_bucket(
+                   index, header, FILE_TABLE, (hash + probe) & (header.bucket_count - 1), bucket) ||
+               bucket == 0) {
+                return false;
+            }
+            if(read_record(bucket - 1, into) && into.file_hash == hash &&
+               strcmp(into.file, name) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Writes a new index next to the old one, then swaps them
+     * @param reuse Whether records of the current index can be kept
+     */
+    bool rebuild(bool reuse) {
+        snprintf(rebuilt_path, sizeof(rebuilt_path), "%s/%s", DIRECTORY, REBUILT_NAME);
+        File* out = storage_file_alloc(storage);
+        File* directory = storage_file_alloc(storage);
+        IndexHeader written{MAGIC, VERSION, sizeof(IndexRecord), 0, 0};
+        bool ok = storage_dir_open(directory, DIRECTORY) &&
+                  storage_file_open(out, rebuilt_path, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS) &&
+                  storage_file_write(out, &written, sizeof(written)) == sizeof(written);
+
+        uint32_t kept = 0;
+        uint32_t parsed = 0;
+        FileInfo info;
+        while(ok && storage_dir_read(directory, &info, file_name, sizeof(file_name))) {
+            if(!is_indexable(info, file_name)) {
+                continue;
+            }
+            if(written.count == MAX_RECIPES) {
+                FURI_LOG_W(PROCESS_LIBRARY_TAG, "Only the first %u recipes", (unsigned int)MAX_RECIPES);
+                break;
+            }
+            uint32_t modified = modified_time(file_name);
+            uint32_t size = static_cast<uint32_t>(info.size);
+            if(reuse && find_previous(file_name, written.count, record) && record.size == size &&
+               record.modified == modified) {
+                kept++;
+            } else {
+                record = IndexRecord{};
+                if(recipe_path(file_name) && loaded.load(storage, path)) {
+                    summarize(*loaded.get(), record.summary);
+                } else {
+                    FURI_LOG_W(
+                        PROCESS_LIBRARY_TAG,
+                        "%s: error on line %u",
+                        file_name,
+                        (unsigned int)loaded.get_error_line());
+                    strcpy(record.summary.name, file_name);
+                    snprintf(
+                        record.summary.film,
+                        sizeof(record.summary.film),
+                        "Error on line %u",
+                        (unsigned int)loaded.get_error_line());
+                }
+                record.name_hash = hash_name(record.summary.name);
+                record.file_hash = hash_name(file_name);
+                record.modified = modified;
+                record.size = size;
+                strcpy(record.file, file_name);
+                parsed++;
+            }
+            ok = storage_file_write(out, &record, sizeof(record)) == sizeof(record);
+            written.count++;
+        }
+        storage_dir_close(directory);
+        storage_file_free(directory);
+
+        if(ok) {
+            ok = write_buckets(out, written);
+        }
+        ok = ok && storage_file_seek(out, 0, true) &&
+             storage_file_write(out, &written, sizeof(written)) == sizeof(written);
+        storage_file_close(out);
+        storage_file_free(out);
+        if(storage_file_is_open(index)) {
+            storage_file_close(index);
+        }
+
+        snprintf(path, sizeof(path), "%s/%s", DIRECTORY, INDEX_NAME);
+        if(ok) {
+            storage_common_remove(storage, path);
+            ok = storage_common_rename(storage, rebuilt_path, path) == FSE_OK;
+        }
+        if(!ok) {
+            FURI_LOG_E(PROCESS_LIBRARY_TAG, "Cannot write the index in %s", DIRECTORY);
+            storage_common_remove(storage, rebuilt_path);
+            return false;
+        }
+        FURI_LOG_I(
+            PROCESS_LIBRARY_TAG,
+            "Indexed %lu recipes, %lu parsed, %lu unchanged",
+            (unsigned long)written.count,
+            (unsigned long)parsed,
+            (unsigned long)kept);
+        return true;
+    }
+
+    // Appends the name and file hash tables to the records written so far
+    bool write_buckets(File* out, IndexHeader& written) {
+        written.bucket_count = 0;
+        if(written.count == 0) {
+            return true;
+        }
+        written.bucket_count = 1;
+        while(written.bucket_count < written.count * 2) {
+            written.bucket_count *= 2;
+        }
+
+        uint16_t empty[16] = {};
+        uint32_t buckets = written.bucket_count * 2;
+        for(uint32_t bucket = 0; bucket < buckets; bucket += 16) {
+            size_t bytes = sizeof(uint16_t) * (buckets - bucket < 16 ? buckets - bucket : 16);
+            if(storage_file_write(out, empty, bytes) != bytes) {
+                return false;
+            }
+        }
+
+        for(uint32_t number = 0; number < written.count; number++) {
+            uint32_t hashes[2] = {};
+            if(!storage_file_seek(out, record_offset(number), true) ||
+               storage_file_read(out, hashes, sizeof(hashes)) != sizeof(hashes) ||
+               !insert_bucket(out, written, NAME_TABLE, hashes[0], number) ||
+               !insert_bucket(out, written, FILE_TABLE, hashes[1], number)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool insert_bucket(
+        File* out,
+        const IndexHeader& written,
+        uint32_t table,
+        uint32_t hash,
+        uint32_t number) {
+        for(uint32_t probe = 0;; probe++) {
+            uint32_t bucket = (hash + probe) & (written.bucket_count - 1);
+            uint16_t value = 0;
+            if(!read_bucket(out, written, table, bucket, value)) {
+                return false;
+            }
+            if(value == 0) {
+                value = static_cast<uint16_t>(number + 1);
+                return storage_file_seek(out, bucket_offset(written, table, bucket), true) &&
+                       storage_file_write(out, &value, sizeof(value)) == sizeof(value);
+            }
+        }
+    }
+
+    Storage* storage{nullptr};
+    File* index{nullptr};
+    IndexHeader header{};
+    uint32_t builtin_hashes[AGITATION_PROCESS_COUNT];
+    // Scratch space, off the stack
+    IndexRecord record{};
+    char file_name[MAX_FILE_NAME + 32];
+    char path[LoadedProcess::MAX_PATH];
+    char rebuilt_path[LoadedProcess::MAX_PATH];
+    LoadedProcess loaded;
+};
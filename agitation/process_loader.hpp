@@ -0,0 +1,534 @@
+#pragma once
+
+#include "agitation_pattern.hpp"
+#include "agitation_sequence.hpp"
+#include "dev_time_loader.hpp"
+#include "packed_sequence.hpp"
+#include <furi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <storage/storage.h>
+
+#define PROCESS_LOADER_TAG "ProcessLoader"
+
+/**
+ * @brief A process read from a text recipe on the SD card.
+ *
+ * One directive per line, # starts a comment. Process directives come
+ * first, then each step opens with step and takes the directives below it:
+ * ```
+ * name Rodinal 1+50 Stand
+ * film Black and White Negative
+ * tank Paterson
+ * chemistry Rodinal
+ * temperature 20
+ *
+ * step Developer
+ * description Stand development, one agitation halfway
+ * minutes 60
+ * agitation repeat 4 ( cw 1 pause 1 ccw 1 pause 1 )
+ * agitation pause 1770 repeat 2 ( cw 1 pause 1 ccw 1 pause 1 )
+ * confirm
+ *
+ * step Fixer
+ * minutes 5
+ * agitation repeat forever ( cw 2 pause 28 )
+ * ```
+ * unit (celsius, the default, or fahrenheit) sets the unit of every
+ * temperature. A step is timed by minutes or seconds, by a table (a
+ * DevTimeTable file, see dev_time_loader.hpp, relative to the recipe),
+ * or otherwise by its agitation up to the first wait. Agitation lines
+ * append cw, ccw and pause movements in seconds, wait for the user, and
+ * loops of repeat count or forever, optionally for a number of seconds,
+ * around a body in parentheses. Lines may split a loop.
+ *
+ * Everything is held in fixed arrays, the sequences are packed as the
+ * built-in ones are. The object is several kilobytes: keep it static.
+ */
+class LoadedProcess {
+public:
+    static constexpr size_t MAX_STEPS = 8;
+    static constexpr size_t MAX_WORDS = 128; // Packed words, all steps
+    static constexpr size_t MAX_TOKENS = 64; // Movements and loop ends, per step
+    static constexpr size_t MAX_TEXT = 32;
+    static constexpr size_t MAX_DESCRIPTION = 48;
+    static constexpr size_t MAX_LINE = 128;
+    static constexpr size_t MAX_PATH = 128;
+
+    LoadedProcess() {
+        clear();
+    }
+
+    void clear() {
+        process = AgitationProcessStatic{};
+        process.process_name = name;
+        process.film_type = film;
+        process.tank_type = tank;
+        process.chemistry = chemistry;
+        process.steps = steps;
+        name[0] = film[0] = tank[0] = chemistry[0] = '\0';
+        words_used = 0;
+        token_count = 0;
+        depth = 0;
+        has_table = false;
+        storage = nullptr;
+        directory[0] = '\0';
+        error_line = 0;
+        line_number = 0;
+        finished = false;
+    }
+
+    /**
+     * @brief Read a recipe
+     * @return false if the file or its table cannot be read or is
+     * malformed, see get_error_line()
+     */
+    bool load(Storage* storage, const char* path) {
+        clear();
+        this->storage = storage;
+        const char* slash = strrchr(path, '/');
+        size_t length = slash ? static_cast<size_t>(slash - path) : 0;
+        if(length >= MAX_PATH) {
+            FURI_LOG_E(PROCESS_LOADER_TAG, "Path too long: %s", path);
+            return false;
+        }
+        memcpy(directory, path, length);
+        directory[length] = '\0';
+
+        File* file = storage_file_alloc(storage);
+        bool ok = storage_file_open(file, path, FSAM_READ, FSOM_OPEN_EXISTING);
+        if(!ok) {
+            FURI_LOG_E(PROCESS_LOADER_TAG, "Cannot open %s", path);
+        }
+
+        // Same small chunks as LoadedDevTimeTable, the line lives in the
+        // object rather than on the stack
+        length = 0;
+        char chunk[32];
+        size_t read = 0;
+        while(ok && (read = storage_file_read(file, chunk, sizeof(chunk))) > 0) {
+            for(size_t i = 0; ok && i < read; i++) {
+                if(chunk[i] == '\n') {
+                    line[length] = '\0';
+                    ok = parse_line(line);
+                    length = 0;
+                } else if(length + 1 < MAX_LINE) {
+                    line[length++] = chunk[i];
+                } else {
+                    FURI_LOG_E(
+                        PROCESS_LOADER_TAG, "Line %u too long", (unsigned int)(line_number + 1));
+                    error_line = line_number + 1;
+                    ok = false;
+                }
+            }
+        }
+        if(ok && length > 0) {
+            line[length] = '\0';
+            ok = parse_line(line);
+        }
+
+        storage_file_close(file);
+        storage_file_free(file);
+        return ok && finish();
+    }
+
+    /**
+     * @brief Take one line of the text format
+     * @return false if the line is malformed
+     */
+    bool parse_line(char* text) {
+        line_number++;
+        char* comment = strchr(text, '#');
+        if(comment) {
+            *comment = '\0';
+        }
+
+        char* rest = nullptr;
+        char* directive = strtok_r(text, " \t\r", &rest);
+        if(!directive) {
+            return true;
+        }
+        if(strcmp(directive, "step") == 0) {
+            return begin_step(rest);
+        }
+        if(strcmp(directive, "unit") == 0) {
+            char* unit = strtok_r(nullptr, " \t\r", &rest);
+            if(unit && strcmp(unit, "celsius") == 0) {
+                process.fahrenheit = false;
+                return true;
+            }
+            if(unit && strcmp(unit, "fahrenheit") == 0) {
+                process.fahrenheit = true;
+                return true;
+            }
+            return fail("unknown unit");
+        }
+        if(strcmp(directive, "temperature") == 0) {
+            char* value = strtok_r(nullptr, " \t\r", &rest);
+            float& temperature = in_step() ? current().temperature : process.temperature;
+            if(!value || !parse_number(value, temperature)) {
+                return fail("bad temperature");
+            }
+            return true;
+        }
+        if(!in_step()) {
+            if(strcmp(directive, "name") == 0) {
+                return copy_text(name, sizeof(name), rest);
+            }
+            if(strcmp(directive, "film") == 0) {
+                return copy_text(film, sizeof(film), rest);
+            }
+            if(strcmp(directive, "tank") == 0) {
+                return copy_text(tank, sizeof(tank), rest);
+            }
+            if(strcmp(directive, "chemistry") == 0) {
+                return copy_text(chemistry, sizeof(chemistry), rest);
+            }
+            return fail("unknown process directive");
+        }
+
+        if(strcmp(directive, "description") == 0) {
+            return copy_text(descriptions[process.steps_length - 1], MAX_DESCRIPTION, rest);
+        }
+        if(strcmp(directive, "minutes") == 0 || strcmp(directive, "seconds") == 0) {
+            char* value = strtok_r(nullptr, " \t\r", &rest);
+            float amount;
+            if(!value || !parse_number(value, amount) || amount < 0) {
+                return fail("bad time");
+            }
+            float scale = directive[0] == 'm' ? 60.0f : 1.0f;
+            current().time_model = AgitationTimeModelFixed;
+            current().duration_ms = AGITATION_SECONDS(amount * scale);
+            return true;
+        }
+        if(strcmp(directive, "table") == 0) {
+            return load_table(strtok_r(nullptr, " \t\r", &rest));
+        }
+        if(strcmp(directive, "confirm") == 0) {
+            current().requires_confirmation = true;
+            return true;
+        }
+        if(strcmp(directive, "agitation") == 0) {
+            return parse_agitation(rest);
+        }
+        return fail("unknown step directive");
+    }
+
+    /**
+     * @brief Close the last step once every line is in
+     * @return false if the recipe has no name or steps, or a loop is open
+     */
+    bool finish() {
+        if(in_step() && !end_step()) {
+            return false;
+        }
+        if(name[0] == '\0') {
+            return fail("no name");
+        }
+        if(process.steps_length == 0) {
+            return fail("no steps");
+        }
+        finished = true;
+        return true;
+    }
+
+    // Usable once load() or finish() succeeded
+    const AgitationProcessStatic* get() const {
+        return finished ? &process : nullptr;
+    }
+
+    // Line of the first error, 0 if none
+    size_t get_error_line() const {
+        return error_line;
+    }
+
+private:
+    enum class TokenType : uint8_t {
+        Movement,
+        LoopOpen,
+        LoopClose,
+    };
+
+    struct Token {
+        TokenType type;
+        AgitationMovementType movement;
+        uint32_t value; // Duration, or loop count
+        uint32_t max_duration; // Loops only
+    };
+
+    bool fail(const char* reason) {
+        FURI_LOG_E(PROCESS_LOADER_TAG, "Line %u: %s", (unsigned int)line_number, reason);
+        if(error_line == 0) {
+            error_line = line_number;
+        }
+        return false;
+    }
+
+    static bool parse_number(const char* text, float& value) {
+        char* end = nullptr;
+        value = strtof(text, &end);
+        return end != text && *end == '\0';
+    }
+
+    static bool parse_seconds(const char* text, uint32_t& duration_ms) {
+        float seconds;
+        if(!text || !parse_number(text, seconds) || seconds < 0 ||
+           seconds > packed_sequence::DURATION_MASK / 1000.0f) {
+            return false;
+        }
+        duration_ms = AGITATION_SECONDS(seconds);
+        return true;
+    }
+
+    // The rest of the line, trimmed
+    bool copy_text(char* destination, size_t size, char* rest) {
+        while(rest && (*rest == ' ' || *rest == '\t')) {
+            rest++;
+        }
+        size_t length = rest ? strlen(rest) : 0;
+        while(length > 0 && strchr(" \t\r", rest[length - 1])) {
+            length--;
+        }
+        if(length == 0) {
+            return fail("empty text");
+        }
+        if(length >= size) {
+            return fail("text too long");
+        }
+        memcpy(destination, rest, length);
+        destination[length] = '\0';
+        return true;
+    }
+
+    bool in_step() const {
+        return process.steps_length > 0;
+    }
+
+    AgitationStepStatic& current() {
+        return steps[process.steps_length - 1];
+    }
+
+    bool begin_step(char* rest) {
+        if(in_step() && !end_step()) {
+            return false;
+        }
+        if(process.steps_length == MAX_STEPS) {
+            return fail("too many steps");
+        }
+        size_t index = process.steps_length;
+        if(!copy_text(step_names[index], MAX_TEXT, rest)) {
+            return false;
+        }
+        descriptions[index][0] = '\0';
+        steps[index] = AgitationStepStatic{};
+        steps[index].name = step_names[index];
+        steps[index].description = descriptions[index];
+        steps[index].temperature = process.temperature;
+        process.steps_length++;
+        token_count = 0;
+        depth = 0;
+        return true;
+    }
+
+    bool load_table(const char* file_name) {
+        if(!file_name) {
+            return fail("no table file");
+        }
+        if(has_table) {
+            return fail("one table per recipe");
+        }
+        char path[MAX_PATH];
+        int written = file_name[0] == '/' ?
+                          snprintf(path, sizeof(path), "%s", file_name) :
+                          snprintf(path, sizeof(path), "%s/%s", directory, file_name);
+        if(written < 0 || static_cast<size_t>(written) >= sizeof(path)) {
+            return fail("table path too long");
+        }
+        if(!dev_table.load(storage, path)) {
+            return fail("bad table");
+        }
+        has_table = true;
+        current().time_model = AgitationTimeModelDevTable;
+        current().dev_table = dev_table.get();
+        return true;
+    }
+
+    bool push_token(const Token& token) {
+        if(token_count == MAX_TOKENS) {
+            return fail("too many movements");
+        }
+        tokens[token_count++] = token;
+        return true;
+    }
+
+    bool parse_agitation(char* rest) {
+        for(char* word = strtok_r(nullptr, " \t\r", &rest); word;
+            word = strtok_r(nullptr, " \t\r", &rest)) {
+            Token token{TokenType::Movement, AgitationMovementTypePause, 0, 0};
+            if(strcmp(word, "cw") == 0 || strcmp(word, "ccw") == 0 ||
+               strcmp(word, "pause") == 0) {
+                token.movement = word[0] == 'p'  ? AgitationMovementTypePause :
+                                 word[1] == 'w' ? AgitationMovementTypeCW :
+                                                  AgitationMovementTypeCCW;
+                if(!parse_seconds(strtok_r(nullptr, " \t\r", &rest), token.value)) {
+                    return fail("bad seconds");
+                }
+            } else if(strcmp(word, "wait") == 0) {
+                token.movement = AgitationMovementTypeWaitUser;
+            } else if(strcmp(word, "repeat") == 0) {
+                if(!parse_repeat(rest, token)) {
+                    return false;
+                }
+            } else if(strcmp(word, ")") == 0) {
+                if(depth == 0) {
+                    return fail("unmatched )");
+                }
+                depth--;
+                token.type = TokenType::LoopClose;
+            } else {
+                return fail("unknown movement");
+            }
+            if(!push_token(token)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // repeat count|forever [for seconds] (
+    bool parse_repeat(char*& rest, Token& token) {
+        token.type = TokenType::LoopOpen;
+        token.movement = AgitationMovementTypeLoop;
+        char* count = strtok_r(nullptr, " \t\r", &rest);
+        float value;
+        if(count && strcmp(count, "forever") == 0) {
+            token.value = 0;
+        } else if(
+            count && parse_number(count, value) && value >= 1 &&
+            value <= packed_sequence::COUNT_MASK) {
+            token.value = static_cast<uint32_t>(value);
+        } else {
+            return fail("bad repeat count");
+        }
+        char* next = strtok_r(nullptr, " \t\r", &rest);
+        if(next && strcmp(next, "for") == 0) {
+            if(!parse_seconds(strtok_r(nullptr, " \t\r", &rest), token.max_duration) ||
+               token.max_duration == 0) {
+                return fail("bad repeat seconds");
+            }
+            next = strtok_r(nullptr, " \t\r", &rest);
+        }
+        if(!next || strcmp(next, "(") != 0) {
+            return fail("repeat without (");
+        }
+        if(++depth >= agitation_pattern::MAX_DEPTH) {
+            return fail("loops nested too deep");
+        }
+        return true;
+    }
+
+    // Movements directly in the tokens from first up to the matching close
+    size_t count_movements(size_t first) const {
+        size_t count = 0;
+        size_t level = 0;
+        for(size_t i = first; i < token_count; i++) {
+            if(tokens[i].type == TokenType::LoopClose) {
+                if(level == 0) {
+                    break;
+                }
+                level--;
+            } else {
+                if(level == 0) {
+                    count++;
+                }
+                if(tokens[i].type == TokenType::LoopOpen) {
+                    level++;
+                }
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Lays the movements from the token at cursor out in the pool,
+     * each body contiguous, and leaves cursor after the closing token
+     */
+    AgitationMovementStatic* build(size_t& cursor, size_t& length) {
+        length = count_movements(cursor);
+        AgitationMovementStatic* block = &movements[movements_used];
+        movements_used += length;
+        for(size_t i = 0; i < length; i++) {
+            const Token& token = tokens[cursor++];
+            AgitationMovementStatic& movement = block[i];
+            movement = AgitationMovementStatic{};
+            movement.type = token.movement;
+            if(token.type == TokenType::LoopOpen) {
+                movement.loop.count = token.value;
+                movement.loop.max_duration = token.max_duration;
+                movement.loop.sequence = build(cursor, movement.loop.sequence_length);
+            } else {
+                movement.duration = token.value;
+            }
+        }
+        if(cursor < token_count && tokens[cursor].type == TokenType::LoopClose) {
+            cursor++;
+        }
+        return block;
+    }
+
+    bool end_step() {
+        if(depth > 0) {
+            return fail("repeat without )");
+        }
+        // Never more movements than tokens
+        movements_used = 0;
+        size_t cursor = 0;
+        size_t length = 0;
+        const AgitationMovementStatic* sequence = build(cursor, length);
+
+        size_t used = 0;
+        packed_sequence::PackError error = packed_sequence::pack(
+            sequence, length, &words[words_used], source, MAX_WORDS - words_used, used);
+        if(error != packed_sequence::PackError::None) {
+            return fail(
+                error == packed_sequence::PackError::TooManyWords ? "too many movements" :
+                                                                    "agitation does not pack");
+        }
+        current().sequence = PackedSequence{&words[words_used], length};
+        words_used += used;
+        if(current().time_model == AgitationTimeModelSequence &&
+           agitation_pattern::measure(current().sequence).duration_ms ==
+               agitation_pattern::FOREVER) {
+            return fail("endless agitation needs a time");
+        }
+        return true;
+    }
+
+    AgitationProcessStatic process;
+    char name[MAX_TEXT];
+    char film[MAX_TEXT];
+    char tank[MAX_TEXT];
+    char chemistry[MAX_TEXT];
+    AgitationStepStatic steps[MAX_STEPS];
+    char step_names[MAX_STEPS][MAX_TEXT];
+    char descriptions[MAX_STEPS][MAX_DESCRIPTION];
+    uint32_t words[MAX_WORDS];
+    size_t words_used;
+    LoadedDevTimeTable dev_table;
+    bool has_table;
+
+    // Parsing state
+    Token tokens[MAX_TOKENS];
+    size_t token_count;
+    size_t depth;
+    AgitationMovementStatic movements[MAX_TOKENS];
+    size_t movements_used;
+    const AgitationMovementStatic* source[MAX_WORDS];
+    Storage* storage;
+    char directory[MAX_PATH];
+    char line[MAX_LINE];
+    size_t line_number;
+    size_t error_line;
+    bool finished;
+};
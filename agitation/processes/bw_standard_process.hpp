@@ -9,7 +9,7 @@
 /**
  * @brief Standard B&W Initial Agitation Step
  */
-static const AgitationMovementStatic INITIAL_AGITATION[] = {
+static constexpr AgitationMovementStatic INITIAL_AGITATION[] = {
     {.type = AgitationMovementTypeLoop,
      .loop =
          {
@@ -18,34 +18,33 @@ static const AgitationMovementStatic INITIAL_AGITATION[] = {
              .sequence = (const struct AgitationMovementStatic*)STANDARD_INVERSION,
              .sequence_length = STANDARD_INVERSION_LENGTH,
          }},
-    {.type = AgitationMovementTypePause, .duration = 24},
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(24)},
 };
-static const size_t INITIAL_AGITATION_LENGTH = 2;
+AGITATION_PACKED_SEQUENCE(INITIAL_AGITATION_PACKED, INITIAL_AGITATION);
 
 static const AgitationStepStatic BW_INITIAL_AGITATION_STEP = {
     .name = "Initial Agitation",
     .description = "First round of agitation to ensure even development",
     .temperature = 20.0f,
-    .sequence = INITIAL_AGITATION,
-    .sequence_length = INITIAL_AGITATION_LENGTH};
+    .sequence = INITIAL_AGITATION_PACKED};
 
 /**
  * @brief Standard B&W Periodic Agitation Step
  */
-static const AgitationMovementStatic BW_PERIODIC_AGITATION_SEQUENCE[] = {
+static constexpr AgitationMovementStatic BW_PERIODIC_AGITATION_SEQUENCE[] = {
     {.type = AgitationMovementTypeLoop,
      .loop = {
          .count = 2,
          .max_duration = 0,
          .sequence = (const struct AgitationMovementStatic*)STANDARD_INVERSION,
          .sequence_length = STANDARD_INVERSION_LENGTH}}};
+AGITATION_PACKED_SEQUENCE(BW_PERIODIC_AGITATION_PACKED, BW_PERIODIC_AGITATION_SEQUENCE);
 
 static const AgitationStepStatic BW_PERIODIC_AGITATION_STEP = {
     .name = "Periodic Agitation",
     .description = "Continued agitation during development",
     .temperature = 20.0f,
-    .sequence = BW_PERIODIC_AGITATION_SEQUENCE,
-    .sequence_length = 1};
+    .sequence = BW_PERIODIC_AGITATION_PACKED};
 
 // B&W Standard Development Static Steps
 static const AgitationStepStatic BW_STANDARD_DEV_STEPS[] = {
@@ -7,32 +7,32 @@
 //------------------------------------------------------------------------------
 
 // Number of rolls being developed (affects development time)
-static const int NUMBER_OF_ROLLS = 10; // Adjust this value as needed
+static constexpr int NUMBER_OF_ROLLS = 10; // Adjust this value as needed
 
 // Base development time in seconds (3.5 minutes = 210 seconds)
-static const double BASE_DEVELOPER_TIME = 210.0;
+static constexpr double BASE_DEVELOPER_TIME = 210.0;
 
 /**
  * @brief C41 Color Developer Stage (Constant CW Agitation)
  */
-static const AgitationMovementStatic C41_COLOR_DEVELOPER[] = {
+static constexpr AgitationMovementStatic C41_COLOR_DEVELOPER[] = {
     {.type = AgitationMovementTypeCW,
-     .duration = static_cast<uint32_t>(BASE_DEVELOPER_TIME *
-                                       pow(1.02f, NUMBER_OF_ROLLS - 1))},
+     .duration = AGITATION_SECONDS(BASE_DEVELOPER_TIME *
+                                   pow(1.02f, NUMBER_OF_ROLLS - 1))},
     {.type = AgitationMovementTypeWaitUser,
      .message = "Development complete. Ready for blix?"},
 };
-static const size_t C41_COLOR_DEVELOPER_LENGTH = 2;
+AGITATION_PACKED_SEQUENCE(C41_COLOR_DEVELOPER_PACKED, C41_COLOR_DEVELOPER);
 
 /**
  * @brief C41 Bleach/Fix (Blix) Stage (Constant CW Agitation)
  */
-static const AgitationMovementStatic C41_BLEACH_SEQUENCE[] = {
-    {.type = AgitationMovementTypeCW, .duration = 8 * 60},
+static constexpr AgitationMovementStatic C41_BLEACH_SEQUENCE[] = {
+    {.type = AgitationMovementTypeCW, .duration = AGITATION_SECONDS(8 * 60)},
     {.type = AgitationMovementTypeWaitUser,
      .message = "Blix complete. Process finished!"},
 };
-static const size_t C41_BLEACH_LENGTH = 3;
+AGITATION_PACKED_SEQUENCE(C41_BLEACH_PACKED, C41_BLEACH_SEQUENCE);
 
 //------------------------------------------------------------------------------
 // C41 Process Steps
@@ -46,8 +46,7 @@ static const AgitationStepStatic C41_COLOR_DEVELOPER_STEP = {
     .description =
         "Main color development stage with continuous gentle agitation",
     .temperature = 38.0f,
-    .sequence = C41_COLOR_DEVELOPER,
-    .sequence_length = C41_COLOR_DEVELOPER_LENGTH};
+    .sequence = C41_COLOR_DEVELOPER_PACKED};
 
 /**
  * @brief C41 Bleach Step
@@ -56,8 +55,7 @@ static const AgitationStepStatic C41_BLEACH_STEP = {
     .name = "Bleach",
     .description = "Bleach stage with periodic gentle agitation",
     .temperature = 38.0f,
-    .sequence = C41_BLEACH_SEQUENCE,
-    .sequence_length = C41_BLEACH_LENGTH};
+    .sequence = C41_BLEACH_PACKED};
 
 // C41 Full Process Static Steps (removed pre-wash and stabilizer)
 static const AgitationStepStatic C41_FULL_PROCESS_STEPS[] = {
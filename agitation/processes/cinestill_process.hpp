@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common_sequences.hpp"
+#include "../dev_time_table.hpp"
+
+//------------------------------------------------------------------------------
+// CineStill Cs41 Process
+//------------------------------------------------------------------------------
+
+// Developer temperatures in Fahrenheit and push/pull stops
+static constexpr float CINESTILL_TEMPERATURES[] = {75.0, 80.0, 85.0, 90.0, 95.0, 102.0};
+static constexpr float CINESTILL_PUSH_PULL[] = {-1, 0, 1, 2, 3};
+
+// Developer minutes, one row per push/pull, -1 where CineStill gives no time
+static constexpr float CINESTILL_MINUTES[] = {
+    27.0, 16.25, 10.0, 6.5, 4.5, 2.75, // Pull 1
+    35.0, 21.0, 13.0, 8.5, 5.75, 3.5, // Normal
+    50.0, 28.0, 17.0, 11.0, 7.5, 4.55, // Push 1
+    -1.0, 37.0, 25.0, 14.75, 10.0, 6.13, // Push 2
+    -1.0, -1.0, 35.0, 21.0, 14.33, 8.75, // Push 3
+};
+DEV_TIME_SLOPES(CINESTILL_SLOPES, CINESTILL_TEMPERATURES, CINESTILL_MINUTES);
+
+static constexpr DevTimeTable CINESTILL_DEV_TABLE = {
+    .axes =
+        {{DevTimeAxisKind::Temperature,
+          CINESTILL_TEMPERATURES,
+          sizeof(CINESTILL_TEMPERATURES) / sizeof(CINESTILL_TEMPERATURES[0])},
+         {DevTimeAxisKind::PushPull,
+          CINESTILL_PUSH_PULL,
+          sizeof(CINESTILL_PUSH_PULL) / sizeof(CINESTILL_PUSH_PULL[0])}},
+    .axis_count = 2,
+    .minutes = CINESTILL_MINUTES,
+    .slopes = CINESTILL_SLOPES.data(),
+    .exhaustion_per_roll = 0.02f,
+    .fahrenheit = true};
+static_assert(dev_time_table::is_valid(CINESTILL_DEV_TABLE), "CineStill table is malformed");
+static_assert(
+    dev_time_table::cell_count(CINESTILL_DEV_TABLE) ==
+        sizeof(CINESTILL_MINUTES) / sizeof(CINESTILL_MINUTES[0]),
+    "CineStill minutes do not match its axes");
+
+/**
+ * @brief CineStill Developer Step (Constant CW Rotation)
+ */
+static const AgitationStepStatic CINESTILL_DEVELOPER_STEP = {
+    .name = "Developer",
+    .description = "Color development, time from temperature, push/pull and rolls",
+    .temperature = 102.0f,
+    .sequence = {},
+    .time_model = AgitationTimeModelDevTable,
+    .duration_ms = 0,
+    .dev_table = &CINESTILL_DEV_TABLE,
+    .requires_confirmation = true};
+
+/**
+ * @brief CineStill Blix Step (Constant CW Rotation)
+ */
+static const AgitationStepStatic CINESTILL_BLIX_STEP = {
+    .name = "Blix",
+    .description = "Bleach and fix",
+    .temperature = 102.0f,
+    .sequence = {},
+    .time_model = AgitationTimeModelFixed,
+    .duration_ms = AGITATION_SECONDS(8 * 60),
+    .dev_table = nullptr,
+    .requires_confirmation = true};
+
+static const AgitationStepStatic CINESTILL_STEPS[] = {
+    CINESTILL_DEVELOPER_STEP,
+    CINESTILL_BLIX_STEP};
+
+/**
+ * @brief CineStill Cs41 Process, temperatures in Fahrenheit
+ */
+static const AgitationProcessStatic CINESTILL_C41_STATIC = {
+    .process_name = "CineStill C41",
+    .film_type = "Color Negative",
+    .tank_type = "Rotary Tank",
+    .chemistry = "CineStill Cs41",
+    .temperature = 102.0f,
+    .fahrenheit = true,
+    .steps = CINESTILL_STEPS,
+    .steps_length = 2};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../agitation_sequence.hpp"
+#include "../packed_sequence.hpp"
 
 //------------------------------------------------------------------------------
 // Common Base Sequences
@@ -9,21 +10,21 @@
 /**
  * @brief Basic inversion sequence (CW -> Pause -> CCW -> Pause)
  */
-static const AgitationMovementStatic STANDARD_INVERSION[] = {
-    {.type = AgitationMovementTypeCW, .duration = 1},
-    {.type = AgitationMovementTypePause, .duration = 1},
-    {.type = AgitationMovementTypeCCW, .duration = 1},
-    {.type = AgitationMovementTypePause, .duration = 1},
+static constexpr AgitationMovementStatic STANDARD_INVERSION[] = {
+    {.type = AgitationMovementTypeCW, .duration = AGITATION_SECONDS(1)},
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)},
+    {.type = AgitationMovementTypeCCW, .duration = AGITATION_SECONDS(1)},
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)},
 };
 static const size_t STANDARD_INVERSION_LENGTH = 4;
 
 /**
  * @brief Gentle continuous base sequence
  */
-static const AgitationMovementStatic CONTINUOUS_GENTLE_SEQ[] = {
-    {.type = AgitationMovementTypeCW, .duration = 2},
-    {.type = AgitationMovementTypePause, .duration = 1},
-    {.type = AgitationMovementTypeCCW, .duration = 2},
-    {.type = AgitationMovementTypePause, .duration = 1},
+static constexpr AgitationMovementStatic CONTINUOUS_GENTLE_SEQ[] = {
+    {.type = AgitationMovementTypeCW, .duration = AGITATION_SECONDS(2)},
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)},
+    {.type = AgitationMovementTypeCCW, .duration = AGITATION_SECONDS(2)},
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(1)},
 };
 static const size_t CONTINUOUS_GENTLE_SEQ_LENGTH = 4;
@@ -9,14 +9,14 @@
 /**
  * @brief Continuous gentle agitation (for C41/E6)
  */
-static const AgitationMovementStatic CONTINUOUS_GENTLE[] = {
+static constexpr AgitationMovementStatic CONTINUOUS_GENTLE[] = {
     {.type = AgitationMovementTypeLoop,
      .loop = {
          .count = 0, // Continuous
          .max_duration = 0,
          .sequence = (const struct AgitationMovementStatic*)CONTINUOUS_GENTLE_SEQ,
          .sequence_length = CONTINUOUS_GENTLE_SEQ_LENGTH}}};
-static const size_t CONTINUOUS_GENTLE_LENGTH = 1;
+AGITATION_PACKED_SEQUENCE(CONTINUOUS_GENTLE_PACKED, CONTINUOUS_GENTLE);
 
 /**
  * @brief Continuous Gentle Agitation Step
@@ -25,8 +25,7 @@ static const AgitationStepStatic CONTINUOUS_GENTLE_STEP = {
     .name = "Continuous Gentle Agitation",
     .description = "Gentle, continuous movement for consistent development",
     .temperature = 38.0f, // Typical color development temperature
-    .sequence = CONTINUOUS_GENTLE,
-    .sequence_length = CONTINUOUS_GENTLE_LENGTH};
+    .sequence = CONTINUOUS_GENTLE_PACKED};
 
 // Continuous Gentle Static Steps
 static const AgitationStepStatic CONTINUOUS_GENTLE_STEPS[] = {CONTINUOUS_GENTLE_STEP};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "common_sequences.hpp"
+
+//------------------------------------------------------------------------------
+// Fixed-Time Rotary Processes (Constant CW Rotation)
+//------------------------------------------------------------------------------
+
+static const AgitationStepStatic BW_ROTARY_STEPS[] = {
+    {.name = "Developer",
+     .description = "Developer with constant rotation",
+     .temperature = 20.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(7 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = true},
+    {.name = "Stop",
+     .description = "Stop bath",
+     .temperature = 20.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(60),
+     .dev_table = nullptr,
+     .requires_confirmation = true},
+    {.name = "Fix",
+     .description = "Fixer",
+     .temperature = 20.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(5 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = true},
+    {.name = "Wash",
+     .description = "Final wash",
+     .temperature = 20.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(10 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = false},
+};
+
+/**
+ * @brief Basic B&W Process on a Rotary Processor
+ */
+static const AgitationProcessStatic BW_ROTARY_STATIC = {
+    .process_name = "B&W Rotary",
+    .film_type = "Black and White Negative",
+    .tank_type = "Rotary Tank",
+    .chemistry = "B&W Developer",
+    .temperature = 20.0f,
+    .steps = BW_ROTARY_STEPS,
+    .steps_length = 4};
+
+static const AgitationStepStatic C41_ROTARY_STEPS[] = {
+    {.name = "Developer",
+     .description = "Color developer with constant rotation",
+     .temperature = 38.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(3.5 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = true},
+    {.name = "Blix",
+     .description = "Bleach and fix",
+     .temperature = 38.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(3 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = true},
+    {.name = "Wash",
+     .description = "Final wash",
+     .temperature = 38.0f,
+     .sequence = {},
+     .time_model = AgitationTimeModelFixed,
+     .duration_ms = AGITATION_SECONDS(3 * 60),
+     .dev_table = nullptr,
+     .requires_confirmation = false},
+};
+
+/**
+ * @brief C41 Process on a Rotary Processor
+ */
+static const AgitationProcessStatic C41_ROTARY_STATIC = {
+    .process_name = "C41 Rotary",
+    .film_type = "Color Negative",
+    .tank_type = "Rotary Tank",
+    .chemistry = "C41 Color Chemistry",
+    .temperature = 38.0f,
+    .steps = C41_ROTARY_STEPS,
+    .steps_length = 3};
@@ -9,34 +9,34 @@
 /**
  * @brief Stand Development Initial Agitation Step
  */
-static const AgitationMovementStatic STAND_DEV_INITIAL_SEQUENCE[] = {
+static constexpr AgitationMovementStatic STAND_DEV_INITIAL_SEQUENCE[] = {
     {.type = AgitationMovementTypeLoop,
      .loop = {
          .count = 3,
          .max_duration = 0,
          .sequence = (const struct AgitationMovementStatic*)STANDARD_INVERSION,
          .sequence_length = STANDARD_INVERSION_LENGTH}}};
+AGITATION_PACKED_SEQUENCE(STAND_DEV_INITIAL_PACKED, STAND_DEV_INITIAL_SEQUENCE);
 
 static const AgitationStepStatic STAND_DEV_INITIAL_STEP = {
     .name = "Initial Agitation",
     .description = "Initial agitation before long stand period",
     .temperature = 20.0f,
-    .sequence = STAND_DEV_INITIAL_SEQUENCE,
-    .sequence_length = 1};
+    .sequence = STAND_DEV_INITIAL_PACKED};
 
 /**
  * @brief Stand Development Long Stand Step
  */
-static const AgitationMovementStatic STAND_DEV_LONG_STAND_SEQUENCE[] = {
-    {.type = AgitationMovementTypePause, .duration = 3600} // 1 hour stand
+static constexpr AgitationMovementStatic STAND_DEV_LONG_STAND_SEQUENCE[] = {
+    {.type = AgitationMovementTypePause, .duration = AGITATION_SECONDS(3600)} // 1 hour stand
 };
+AGITATION_PACKED_SEQUENCE(STAND_DEV_LONG_STAND_PACKED, STAND_DEV_LONG_STAND_SEQUENCE);
 
 static const AgitationStepStatic STAND_DEV_LONG_STAND_STEP = {
     .name = "Long Stand",
     .description = "Extended period with minimal agitation",
     .temperature = 20.0f,
-    .sequence = STAND_DEV_LONG_STAND_SEQUENCE,
-    .sequence_length = 1};
+    .sequence = STAND_DEV_LONG_STAND_PACKED};
 
 // Stand Development Static Steps
 static const AgitationStepStatic STAND_DEV_STEPS[] = {
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "film_developer_events.hpp"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Table-driven state machine of FilmDeveloperApp.
+ *
+ * Every (AppState, trigger) pair maps to at most two rules, checked in
+ * order: the first rule whose guard passes is applied. Triggers are the
+ * FilmDeveloperEvent custom events plus the Back key. The table is built at
+ * compile time from a flat rule list, and building it fails to compile when a
+ * pair has no rule, has more than two rules, or could fall through a guard
+ * without an unguarded fallback. Dispatch is then a single array lookup.
+ */
+namespace app_state_machine {
+
+enum class AppState : uint8_t {
+  ProcessSelection,
+  Settings,
+  MainView,
+  Paused,
+  WaitingConfirmation,
+  RuntimeSettings,
+  DispatchDialog,
+  ConfirmRestart,
+  ConfirmSkip,
+  ConfirmStop,
+  ConfirmExit,
+  DebugStats,
+};
+
+constexpr size_t STATE_COUNT = static_cast<size_t>(AppState::DebugStats) + 1;
+
+inline const char *get_state_name(AppState state) {
+  switch (state) {
+  case AppState::ProcessSelection:
+    return "ProcessSelection";
+  case AppState::Settings:
+    return "Settings";
+  case AppState::MainView:
+    return "MainView";
+  case AppState::Paused:
+    return "Paused";
+  case AppState::WaitingConfirmation:
+    return "WaitingConfirmation";
+  case AppState::RuntimeSettings:
+    return "RuntimeSettings";
+  case AppState::DispatchDialog:
+    return "DispatchDialog";
+  case AppState::ConfirmRestart:
+    return "ConfirmRestart";
+  case AppState::ConfirmSkip:
+    return "ConfirmSkip";
+  case AppState::ConfirmExit:
+    return "ConfirmExit";
+  case AppState::ConfirmStop:
+    return "ConfirmStop";
+  case AppState::DebugStats:
+    return "DebugStats";
+  }
+  return "Unknown";
+}
+
+//------------------------------------------------------------------------------
+// Triggers
+//------------------------------------------------------------------------------
+
+// Every FilmDeveloperEvent, in trigger slot order. New events must be added
+// here, and the rule list then has to say what each state does with them.
+constexpr FilmDeveloperEvent TRIGGER_EVENTS[] = {
+    FilmDeveloperEvent::ProcessSelected,
+    FilmDeveloperEvent::SettingsConfirmed,
+    FilmDeveloperEvent::ProcessCompleted,
+    FilmDeveloperEvent::StartProcess,
+    FilmDeveloperEvent::PauseProcess,
+    FilmDeveloperEvent::ResumeProcess,
+    FilmDeveloperEvent::SkipStep,
+    FilmDeveloperEvent::RestartStep,
+    FilmDeveloperEvent::StopProcess,
+    FilmDeveloperEvent::ExitApp,
+    FilmDeveloperEvent::UserActionRequired,
+    FilmDeveloperEvent::UserActionConfirmed,
+    FilmDeveloperEvent::TimerTick,
+    FilmDeveloperEvent::StepComplete,
+    FilmDeveloperEvent::ProcessTick,
+    FilmDeveloperEvent::MotorStateChanged,
+    FilmDeveloperEvent::AgitationComplete,
+    FilmDeveloperEvent::PushPullChanged,
+    FilmDeveloperEvent::RollCountChanged,
+    FilmDeveloperEvent::EnterRuntimeSettings,
+    FilmDeveloperEvent::ExitRuntimeSettings,
+    FilmDeveloperEvent::StepDurationChanged,
+    FilmDeveloperEvent::DispatchDialogDismissed,
+    FilmDeveloperEvent::DispatchDialogConfirmed,
+    FilmDeveloperEvent::DispatchDialogRequested,
+    FilmDeveloperEvent::StateChanged,
+    FilmDeveloperEvent::PauseRequested,
+    FilmDeveloperEvent::ResumeRequested,
+    FilmDeveloperEvent::SkipRequested,
+    FilmDeveloperEvent::RestartRequested,
+    FilmDeveloperEvent::ExitRequested,
+    FilmDeveloperEvent::StopProcessRequested,
+    FilmDeveloperEvent::UserActivity,
+    FilmDeveloperEvent::DebugStatsRequested,
+    FilmDeveloperEvent::PerfStatsRequested,
+    FilmDeveloperEvent::ProcessSearchStep,
+};
+
+constexpr size_t EVENT_TRIGGER_COUNT =
+    sizeof(TRIGGER_EVENTS) / sizeof(TRIGGER_EVENTS[0]);
+// The Back key reaches the app through the navigation callback and gets the
+// slot after the events.
+constexpr uint8_t TRIGGER_BACK = EVENT_TRIGGER_COUNT;
+constexpr size_t TRIGGER_COUNT = EVENT_TRIGGER_COUNT + 1;
+constexpr uint8_t NO_TRIGGER = 0xFF;
+
+constexpr uint32_t max_event_value() {
+  uint32_t max = 0;
+  for (size_t i = 0; i < EVENT_TRIGGER_COUNT; i++) {
+    uint32_t value = static_cast<uint32_t>(TRIGGER_EVENTS[i]);
+    max = value > max ? value : max;
+  }
+  return max;
+}
+
+constexpr uint32_t MAX_EVENT_VALUE = max_event_value();
+
+struct TriggerIndex {
+  uint8_t slots[MAX_EVENT_VALUE + 1];
+};
+
+constexpr TriggerIndex build_trigger_index() {
+  TriggerIndex index{};
+  for (uint32_t value = 0; value <= MAX_EVENT_VALUE; value++) {
+    index.slots[value] = NO_TRIGGER;
+  }
+  for (size_t i = 0; i < EVENT_TRIGGER_COUNT; i++) {
+    index.slots[static_cast<uint32_t>(TRIGGER_EVENTS[i])] =
+        static_cast<uint8_t>(i);
+  }
+  return index;
+}
+
+constexpr TriggerIndex TRIGGER_INDEX = build_trigger_index();
+
+// Maps a raw custom event to its trigger slot, NO_TRIGGER if unknown
+constexpr uint8_t trigger_for(uint32_t event) {
+  return event <= MAX_EVENT_VALUE ? TRIGGER_INDEX.slots[event] : NO_TRIGGER;
+}
+
+constexpr uint8_t trigger_for(FilmDeveloperEvent event) {
+  return trigger_for(static_cast<uint32_t>(event));
+}
+
+inline const char *get_trigger_name(uint8_t trigger) {
+  if (trigger == TRIGGER_BACK) {
+    return "Back";
+  }
+  if (trigger < EVENT_TRIGGER_COUNT) {
+    return get_event_name(TRIGGER_EVENTS[trigger]);
+  }
+  return "Unknown";
+}
+
+//------------------------------------------------------------------------------
+// Rules
+//------------------------------------------------------------------------------
+
+using StateMask = uint16_t;
+
+constexpr StateMask in(AppState state) {
+  return static_cast<StateMask>(1u << static_cast<uint8_t>(state));
+}
+
+template <typename... States>
+constexpr StateMask in(AppState state, States... states) {
+  return in(state) | in(states...);
+}
+
+constexpr StateMask ANY_STATE = static_cast<StateMask>((1u << STATE_COUNT) - 1);
+
+enum class TargetKind : uint8_t {
+  Pass,   // not handled, the event is left to the dispatcher
+  Stay,   // handled without a state change
+  Enter,  // switch to the target state and its view
+  Return, // go back to the state that opened the current dialog
+};
+
+struct Target {
+  TargetKind kind;
+  AppState state;
+};
+
+constexpr Target pass() { return {TargetKind::Pass, AppState::ProcessSelection}; }
+constexpr Target stay() { return {TargetKind::Stay, AppState::ProcessSelection}; }
+constexpr Target to(AppState state) { return {TargetKind::Enter, state}; }
+constexpr Target to_previous() {
+  return {TargetKind::Return, AppState::ProcessSelection};
+}
+
+template <typename Model> struct Guard {
+  bool (*test)(const Model &model);
+};
+
+// An action returning false vetoes the transition; the event still counts as
+// handled.
+template <typename App, typename Model> struct Action {
+  bool (*run)(App &app, Model &model);
+};
+
+template <typename App, typename Model> struct Rule {
+  StateMask states;
+  uint8_t trigger;
+  Guard<Model> guard;
+  Action<App, Model> action;
+  Target target;
+};
+
+constexpr uint8_t NO_RULE = 0xFF;
+constexpr size_t RULES_PER_CELL = 2;
+
+struct TransitionTable {
+  uint8_t cells[STATE_COUNT][TRIGGER_COUNT][RULES_PER_CELL];
+};
+
+// Intentionally not constexpr and never defined: reaching one of these while
+// building the table aborts constant evaluation, which turns a gap in the
+// rule list into a compile error naming the problem.
+void unhandled_state_trigger_pair();
+void too_many_rules_for_state_trigger_pair();
+void guarded_rule_without_fallback();
+
+template <typename App, typename Model, size_t N>
+constexpr TransitionTable build_table(const Rule<App, Model> (&rules)[N]) {
+  static_assert(N < NO_RULE, "Rule indices must fit in a byte");
+  TransitionTable table{};
+  for (size_t state = 0; state < STATE_COUNT; state++) {
+    for (size_t trigger = 0; trigger < TRIGGER_COUNT; trigger++) {
+      size_t count = 0;
+      bool terminated = false;
+      for (size_t i = 0; i < RULES_PER_CELL; i++) {
+        table.cells[state][trigger][i] = NO_RULE;
+      }
+      for (size_t r = 0; r < N && !terminated; r++) {
+        if (rules[r].trigger != trigger ||
+            (rules[r].states & (1u << state)) == 0) {
+          continue;
+        }
+        if (count == RULES_PER_CELL) {
+          too_many_rules_for_state_trigger_pair();
+        }
+        table.cells[state][trigger][count++] = static_cast<uint8_t>(r);
+        terminated = rules[r].guard.test == nullptr;
+      }
+      if (count == 0) {
+        unhandled_state_trigger_pair();
+      }
+      if (!terminated) {
+        guarded_rule_without_fallback();
+      }
+    }
+  }
+  return table;
+}
+
+} // namespace app_state_machine
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Decides how often the screen is refreshed and whether the backlight
+ * may be switched off.
+ *
+ * While the motor agitates the screen refreshes every tick. During a long
+ * pause movement (a stand phase), once nothing has happened for a while,
+ * the display goes to low power. It is redrawn only every SLOW_REFRESH_MS and
+ * the backlight is turned off. It wakes on any user input, on any process
+ * event, and WAKE_LEAD_MS before the pause ends, so the screen is already lit
+ * when the motor starts again. A pause runs from one direction change of
+ * the agitation to the next, however many entries of the sequence it spans,
+ * or to the end of the step.
+ *
+ * All times are in milliseconds of furi_get_tick().
+ */
+class DisplayPolicy {
+public:
+  enum class Mode : uint8_t { Active, LowPower };
+
+  static constexpr uint32_t LONG_PAUSE_MS = 60 * 1000;
+  static constexpr uint32_t WAKE_LEAD_MS = 10 * 1000;
+  static constexpr uint32_t ACTIVITY_HOLD_MS = 15 * 1000;
+  static constexpr uint32_t SLOW_REFRESH_MS = 30 * 1000;
+
+  // Something the user should see happened: stay active for a while
+  void note_activity(uint32_t now) { last_activity_at = now; }
+
+  /**
+   * @brief Re-evaluate the mode after a process tick
+   *
+   * @param motor_idle true if the motor is stopped and no user action is
+   * pending
+   * @param pause_elapsed_ms time the motor has been stopped
+   * @param pause_remaining_ms time until the motor turns again or the step
+   * ends, UINT32_MAX if never
+   * @return true if the mode changed
+   */
+  bool evaluate(uint32_t now, bool motor_idle, uint32_t pause_elapsed_ms,
+                uint32_t pause_remaining_ms) {
+    bool long_pause = motor_idle && (pause_remaining_ms >= LONG_PAUSE_MS ||
+                                     pause_elapsed_ms >=
+                                         LONG_PAUSE_MS - pause_remaining_ms);
+    bool quiet = now - last_activity_at >= ACTIVITY_HOLD_MS;
+
+    Mode next = (long_pause && quiet && pause_remaining_ms > WAKE_LEAD_MS)
+                    ? Mode::LowPower
+                    : Mode::Active;
+    return set_mode(next, now);
+  }
+
+  // Back to full refresh, e.g. when the process stops ticking
+  bool wake(uint32_t now) {
+    last_activity_at = now;
+    return set_mode(Mode::Active, now);
+  }
+
+  // Whether this tick should redraw the screen
+  bool should_redraw(uint32_t now) {
+    if (mode == Mode::Active) {
+      return true;
+    }
+    if (now - last_redraw_at >= SLOW_REFRESH_MS) {
+      last_redraw_at = now;
+      return true;
+    }
+    return false;
+  }
+
+  Mode get_mode() const { return mode; }
+
+  static const char *get_mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::Active:
+      return "Active";
+    case Mode::LowPower:
+      return "LowPower";
+    }
+    return "Unknown";
+  }
+
+private:
+  Mode mode{Mode::Active};
+  uint32_t last_activity_at{0};
+  uint32_t last_redraw_at{0};
+
+  bool set_mode(Mode next, uint32_t now) {
+    if (next == mode) {
+      return false;
+    }
+    mode = next;
+    last_redraw_at = now;
+    return true;
+  }
+};
@@ -0,0 +1,53 @@
+#include "heater_output_embedded.hpp"
+#include <furi_hal_resources.h>
+
+HeaterRelayEmbedded::~HeaterRelayEmbedded() { end(); }
+
+bool HeaterRelayEmbedded::begin() {
+  pin = &gpio_ext_pa4;
+  furi_hal_gpio_write(pin, false);
+  furi_hal_gpio_init(pin, GpioModeOutputPushPull, GpioPullNo, GpioSpeedLow);
+  return true;
+}
+
+void HeaterRelayEmbedded::end() {
+  if (!pin) {
+    return;
+  }
+  furi_hal_gpio_write(pin, false);
+  furi_hal_gpio_init(pin, GpioModeAnalog, GpioPullNo, GpioSpeedLow);
+  pin = nullptr;
+}
+
+void HeaterRelayEmbedded::setPower(float power) {
+  if (pin) {
+    furi_hal_gpio_write(pin, power > 0);
+  }
+}
+
+HeaterPwmEmbedded::~HeaterPwmEmbedded() { end(); }
+
+bool HeaterPwmEmbedded::begin() {
+  duty = 0;
+  furi_hal_pwm_start(FuriHalPwmOutputIdLptim2PA4, FREQUENCY_HZ, duty);
+  running = true;
+  return true;
+}
+
+void HeaterPwmEmbedded::end() {
+  if (!running) {
+    return;
+  }
+  furi_hal_pwm_stop(FuriHalPwmOutputIdLptim2PA4);
+  running = false;
+}
+
+void HeaterPwmEmbedded::setPower(float power) {
+  uint8_t percent = static_cast<uint8_t>(
+      (power < 0 ? 0 : (power > 1.0f ? 1.0f : power)) * 100.0f + 0.5f);
+  // Reprogramming the timer every period would restart its cycle
+  if (running && percent != duty) {
+    duty = percent;
+    furi_hal_pwm_set_params(FuriHalPwmOutputIdLptim2PA4, FREQUENCY_HZ, duty);
+  }
+}
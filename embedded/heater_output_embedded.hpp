@@ -0,0 +1,45 @@
+#pragma once
+#include "../heater_controller.hpp"
+#include <furi.h>
+#include <furi_hal_gpio.h>
+#include <furi_hal_pwm.h>
+
+/**
+ * @brief Relay or solid state relay driving a mains heater, on header pin 4
+ * (PA4), active high. Switched on and off by the controller.
+ */
+class HeaterRelayEmbedded final : public HeaterOutput {
+public:
+  HeaterRelayEmbedded() = default;
+  ~HeaterRelayEmbedded();
+
+  bool begin() override;
+  void end() override;
+  void setPower(float power) override;
+  const char *getName() const override { return "Relay"; }
+
+private:
+  const GpioPin *pin{nullptr};
+};
+
+/**
+ * @brief MOSFET driving a low voltage heater, with hardware PWM on the same
+ * pin
+ */
+class HeaterPwmEmbedded final : public HeaterOutput {
+public:
+  HeaterPwmEmbedded() = default;
+  ~HeaterPwmEmbedded();
+
+  bool begin() override;
+  void end() override;
+  void setPower(float power) override;
+  const char *getName() const override { return "PWM"; }
+  bool isSwitched() const override { return false; }
+
+private:
+  static constexpr uint32_t FREQUENCY_HZ = 1000;
+
+  uint8_t duty{0}; // Percent
+  bool running{false};
+};
@@ -0,0 +1,60 @@
+#include "temperature_source_ds18b20.hpp"
+#include <furi_hal_resources.h>
+#include <one_wire/maxim_crc.h>
+
+TemperatureSourceDs18b20::~TemperatureSourceDs18b20() { end(); }
+
+bool TemperatureSourceDs18b20::begin() {
+  if (host) {
+    return true;
+  }
+  host = onewire_host_alloc(&gpio_ibutton);
+  onewire_host_start(host);
+  // A probe answers a reset with a presence pulse
+  if (!onewire_host_reset(host)) {
+    end();
+    return false;
+  }
+  return true;
+}
+
+void TemperatureSourceDs18b20::end() {
+  if (!host) {
+    return;
+  }
+  onewire_host_stop(host);
+  onewire_host_free(host);
+  host = nullptr;
+}
+
+bool TemperatureSourceDs18b20::sample(float &celsius) {
+  if (!host || !onewire_host_reset(host)) {
+    return false;
+  }
+  onewire_host_write(host, COMMAND_SKIP_ROM);
+  onewire_host_write(host, COMMAND_CONVERT);
+  // Only the sampler thread waits for the conversion
+  furi_delay_ms(CONVERSION_MS);
+
+  if (!onewire_host_reset(host)) {
+    return false;
+  }
+  onewire_host_write(host, COMMAND_SKIP_ROM);
+  onewire_host_write(host, COMMAND_READ_SCRATCHPAD);
+  uint8_t scratchpad[SCRATCHPAD_SIZE];
+  onewire_host_read_bytes(host, scratchpad, SCRATCHPAD_SIZE);
+  // A bus held low reads as zeros, whose CRC is also zero
+  bool all_zero = true;
+  for (uint8_t byte : scratchpad) {
+    all_zero &= byte == 0;
+  }
+  if (all_zero ||
+      maxim_crc8(scratchpad, SCRATCHPAD_SIZE - 1, MAXIM_CRC8_INIT) !=
+      scratchpad[SCRATCHPAD_SIZE - 1]) {
+    return false;
+  }
+
+  int16_t raw = static_cast<int16_t>(scratchpad[1] << 8 | scratchpad[0]);
+  celsius = raw / 16.0f;
+  return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "../temperature_sensor.hpp"
+#include <furi.h>
+#include <furi_hal_gpio.h>
+#include <one_wire/one_wire_host.h>
+
+/**
+ * @brief DS18B20 1-Wire probe, alone on the bus, on the iButton pin
+ * (header pin 17). Read at 12-bit resolution, 0.0625 degrees.
+ */
+class TemperatureSourceDs18b20 final : public TemperatureSource {
+public:
+  TemperatureSourceDs18b20() = default;
+  ~TemperatureSourceDs18b20();
+
+  bool begin() override;
+  void end() override;
+  bool sample(float &celsius) override;
+  const char *getName() const override { return "DS18B20"; }
+  uint32_t getMinPeriodMs() const override { return CONVERSION_MS; }
+
+private:
+  // Worst case 12-bit conversion time from the datasheet
+  static constexpr uint32_t CONVERSION_MS = 750;
+
+  static constexpr uint8_t COMMAND_SKIP_ROM = 0xCC;
+  static constexpr uint8_t COMMAND_CONVERT = 0x44;
+  static constexpr uint8_t COMMAND_READ_SCRATCHPAD = 0xBE;
+  static constexpr size_t SCRATCHPAD_SIZE = 9;
+
+  OneWireHost *host{nullptr};
+};
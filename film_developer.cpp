@@ -1,25 +1,59 @@
+#include "static_storage.hpp"
+
 #include "models/main_view_model.hpp"
+#include "instrumentation.hpp"
 #include "views/app/confirmation_dialog_view.hpp"
+#include "views/app/debug_stats_view.hpp"
 #include "views/app/dispatch_menu_view.hpp"
 #include "views/app/main_development_view.hpp"
 #include "views/app/paused_view.hpp"
 #include "views/app/process_selection_view.hpp"
 #include "views/app/runtime_settings_view.hpp"
 #include "views/app/settings_view.hpp"
+
+// FILM_DEV_HEATER holds the bath at the process temperature with a relay on
+// header pin 4, FILM_DEV_HEATER_PWM with PWM on the same pin
+#if defined(FILM_DEV_HEATER_PWM) && !defined(FILM_DEV_HEATER)
+#define FILM_DEV_HEATER
+#endif
+
 #ifndef HOST
 #include "embedded/motor_controller_embedded.hpp"
+#include "embedded/temperature_source_ds18b20.hpp"
+#ifdef FILM_DEV_HEATER
+#include "embedded/heater_output_embedded.hpp"
+#endif
 #endif
 
-#include "agitation/cinestill_process_interpreter.hpp"
+#include "agitation/interpreter.hpp"
+#include "agitation/interpreter_adapter.hpp"
+#include "app_state_machine.hpp"
+#include "display_policy.hpp"
+#include "heater_controller.hpp"
+#include "temperature_sensor.hpp"
 
 extern "C" {
 #include <furi.h>
 #include <gui/gui.h>
 #include <gui/view_dispatcher.h>
+#include <input/input.h>
+#include <notification/notification_messages.h>
+#include <storage/storage.h>
 }
 
 #define APP_TAG "FilmDev"
 
+#ifdef FILM_DEV_STATIC_STORAGE
+// GUI modules are allocated by the firmware, so in static storage mode they
+// are all created once at startup and kept until exit
+#ifdef FILM_DEV_RELEASE_VIEWS
+#error "FILM_DEV_RELEASE_VIEWS reallocates views and defeats FILM_DEV_STATIC_STORAGE"
+#endif
+#ifndef FILM_DEV_EAGER_VIEWS
+#define FILM_DEV_EAGER_VIEWS
+#endif
+#endif
+
 class FilmDeveloperApp {
 public:
   enum ViewId {
@@ -30,68 +64,61 @@ public:
     ViewDispatchMenu,
     ViewRuntimeSettings,
     ViewPaused,
+    ViewDebugStats,
     ViewCount,
   };
 
-  enum class AppState {
-    ProcessSelection,
-    Settings,
-    MainView,
-    Paused,
-    WaitingConfirmation,
-    RuntimeSettings,
-    DispatchDialog,
-    ConfirmRestart,
-    ConfirmSkip,
-    ConfirmStop,
-    ConfirmExit
-  };
+  using AppState = app_state_machine::AppState;
 
   struct ViewMap {
     ViewId id;
     flipper::ViewCpp *view;
+    const char *name;
+    // Rarely shown views, released when left under FILM_DEV_RELEASE_VIEWS
+    bool transient;
   };
 
-  static const char *get_state_name(AppState state) {
-    switch (state) {
-    case AppState::ProcessSelection:
-      return "ProcessSelection";
-    case AppState::Settings:
-      return "Settings";
-    case AppState::MainView:
-      return "MainView";
-    case AppState::Paused:
-      return "Paused";
-    case AppState::WaitingConfirmation:
-      return "WaitingConfirmation";
-    case AppState::RuntimeSettings:
-      return "RuntimeSettings";
-    case AppState::DispatchDialog:
-      return "DispatchDialog";
-    case AppState::ConfirmRestart:
-      return "ConfirmRestart";
-    case AppState::ConfirmSkip:
-      return "ConfirmSkip";
-    case AppState::ConfirmExit:
-      return "ConfirmExit";
-    case AppState::ConfirmStop:
-      return "ConfirmStop";
-    }
-    return "Unknown";
-  }
-
-  FilmDeveloperApp()
-      : motor_controller(
 #ifdef HOST
-            new MockController()
+  using MotorControllerImpl = RecordingMotor;
+  // Also the heater, so a host run closes the loop
+  using TemperatureSourceImpl = SimulatedBath;
 #else
-            new MotorControllerEmbedded()
+  using MotorControllerImpl = MotorControllerEmbedded;
+  using TemperatureSourceImpl = TemperatureSourceDs18b20;
+#if defined(FILM_DEV_HEATER_PWM)
+  using HeaterOutputImpl = HeaterPwmEmbedded;
+#elif defined(FILM_DEV_HEATER)
+  using HeaterOutputImpl = HeaterRelayEmbedded;
+#endif
+#endif
+  // The concrete motor type lets the interpreter call it directly
+  using ProcessInterpreterImpl =
+      InterpreterAdapter<Interpreter<FuriClock, MotorControllerImpl>>;
+
+  // The app object is statically stored in every build, it is too big for
+  // the 2 KB app stack
+#ifdef FILM_DEV_HEATER
+  static constexpr size_t APP_BUDGET = 2944;
+#else
+  static constexpr size_t APP_BUDGET = 2816;
+#endif
+
+#ifdef FILM_DEV_STATIC_STORAGE
+  // Size budgets of the statically stored objects, checked at compile time
+  static constexpr size_t MOTOR_CONTROLLER_BUDGET = 48;
+  static constexpr size_t PROCESS_INTERPRETER_BUDGET = 208;
+  static constexpr size_t PROCESS_LIBRARY_BUDGET = 9472;
+  static constexpr size_t MODEL_BUDGET = 320;
+  static_assert(sizeof(Model) <= MODEL_BUDGET,
+                "Model exceeds its static storage budget");
 #endif
-                )
-        // , process_interpreter(new AgitationProcessInterpreter())
-        ,
-        process_interpreter(new CineStillProcessInterpreter(motor_controller)),
-        process_view(process_interpreter) {
+
+  FilmDeveloperApp()
+      : motor_controller(create_motor_controller()),
+        process_interpreter(create_process_interpreter(motor_controller)) {
+    // Constructed on the app thread, whose stack the debug view shows
+    MemoryStats::set_app_thread(furi_thread_get_current_id());
+    size_t heap_before = memmgr_get_free_heap();
     gui = static_cast<Gui *>(furi_record_open(RECORD_GUI));
     view_dispatcher = view_dispatcher_alloc();
     view_dispatcher_attach_to_gui(view_dispatcher, gui,
@@ -100,8 +127,19 @@ public:
     view_dispatcher_set_custom_event_callback(view_dispatcher, custom_callback);
     view_dispatcher_set_navigation_event_callback(view_dispatcher,
                                                   navigation_callback);
-    view_dispatcher_set_tick_event_callback(view_dispatcher, timer_callback,
-                                            1000);
+
+    // A one-shot timer instead of the dispatcher's tick event, armed after
+    // each update for the next thing that changes, see schedule_tick()
+    tick_timer = furi_timer_alloc(timer_callback, FuriTimerTypeOnce, this);
+
+    notifications =
+        static_cast<NotificationApp *>(furi_record_open(RECORD_NOTIFICATION));
+    // Every key press wakes the display, whichever view has the focus
+    input_events =
+        static_cast<FuriPubSub *>(furi_record_open(RECORD_INPUT_EVENTS));
+    input_subscription =
+        furi_pubsub_subscribe(input_events, input_callback, this);
+    MemoryStats::record_heap("Dispatcher", heap_before, memmgr_get_free_heap());
 
 #ifndef HOST
     static_cast<MotorControllerEmbedded *>(motor_controller)->initGpio();
@@ -109,30 +147,87 @@ public:
 
     auto model = this->model.lock();
     model->motor_controller = motor_controller;
+    // The feed stays invalid and no temperature is shown until a probe
+    // answers, which the sampler keeps checking for
+    temperature_sampler.start();
+    model->temperature_feed = &temperature_sampler.getFeed();
+    process_interpreter->setTemperatureFeed(&temperature_sampler.getFeed());
+#ifdef FILM_DEV_HEATER
+    // Off until the first update() sets the process temperature
+    heater.start();
+#endif
 
+    {
+      // Only recipes added or changed since the last run are parsed
+      StackProbe probe("Process library");
+      storage = static_cast<Storage *>(furi_record_open(RECORD_STORAGE));
+      process_library = create_process_library();
+      process_library->open(storage);
+      process_interpreter->setProcessLibrary(process_library);
+      process_view.set_library(process_library);
+    }
+
+    HeapProbe heap_probe("Model");
+    StackProbe stack_probe("Model init");
+    process_interpreter->setEventQueue(&process_events);
     process_interpreter->init();
     model->process_interpreter = process_interpreter;
     model->init();
   }
 
   ~FilmDeveloperApp() {
+#ifdef FILM_DEV_HEATER
+    heater.stop();
+#endif
+    temperature_sampler.stop();
+    MemoryStats::log_all();
+    PerfStats::log_all();
+    LockStats lock_stats = model.get_lock().get_stats();
+    FURI_LOG_I(APP_TAG,
+               "Model lock: %lu taken (%lu shared), %lu waited, %lu timed out, "
+               "wait ticks %lu total, %lu max",
+               static_cast<unsigned long>(lock_stats.acquisitions),
+               static_cast<unsigned long>(lock_stats.reads),
+               static_cast<unsigned long>(lock_stats.contended),
+               static_cast<unsigned long>(lock_stats.timeouts),
+               static_cast<unsigned long>(lock_stats.total_wait_ticks),
+               static_cast<unsigned long>(lock_stats.max_wait_ticks));
+
+    if (tick_timer != nullptr) {
+      furi_timer_stop(tick_timer);
+      furi_timer_free(tick_timer);
+    }
+    if (input_subscription != nullptr) {
+      furi_pubsub_unsubscribe(input_events, input_subscription);
+      furi_record_close(RECORD_INPUT_EVENTS);
+    }
+    if (notifications != nullptr) {
+      if (display_policy.get_mode() == DisplayPolicy::Mode::LowPower) {
+        notification_message(notifications, &sequence_display_backlight_on);
+      }
+      furi_record_close(RECORD_NOTIFICATION);
+    }
     if (view_dispatcher != nullptr) {
       FURI_LOG_D(APP_TAG, "Freeing views");
       for (size_t i = 0; i < ViewCount; i++) {
-        view_dispatcher_remove_view(view_dispatcher, static_cast<ViewId>(i));
-        FURI_LOG_D(APP_TAG, "Removed view %d", i);
+        if (view_map[i].view != nullptr && view_map[i].view->is_initialized()) {
+          view_dispatcher_remove_view(view_dispatcher, static_cast<ViewId>(i));
+          FURI_LOG_D(APP_TAG, "Removed view %d", i);
+        }
       }
       view_dispatcher_free(view_dispatcher);
       FURI_LOG_D(APP_TAG, "View dispatcher freed");
       furi_record_close(RECORD_GUI);
       FURI_LOG_D(APP_TAG, "GUI freed");
 
-      delete process_interpreter;
+      destroy_process_interpreter(process_interpreter);
       FURI_LOG_D(APP_TAG, "Process interpreter freed");
+      destroy_process_library(process_library);
+      furi_record_close(RECORD_STORAGE);
 #ifndef HOST
       static_cast<MotorControllerEmbedded *>(motor_controller)->deinitGpio();
 #endif
-      delete motor_controller;
+      destroy_motor_controller(motor_controller);
       FURI_LOG_D(APP_TAG, "Motor controller freed");
     }
   }
@@ -146,18 +241,32 @@ public:
     view_map[ViewDispatchMenu].view = &dispatch_menu_view;
     view_map[ViewRuntimeSettings].view = &runtime_settings_view;
     view_map[ViewPaused].view = &paused_view;
+    view_map[ViewDebugStats].view = &debug_stats_view;
+    debug_stats_view.watch_lock(&model.get_lock());
 
-    // Initialize all views
+    uint32_t start = furi_get_tick();
+    size_t heap_before = memmgr_get_free_heap();
+
+#ifdef FILM_DEV_EAGER_VIEWS
+    const char *mode = "eager";
     for (size_t i = 0; i < ViewCount; i++) {
-      view_map[i].view->set_view_dispatcher(view_dispatcher);
-      view_map[i].view->init();
-      view_dispatcher_add_view(view_dispatcher, static_cast<ViewId>(i),
-                               view_map[i].view->get_view());
+      ensure_view(static_cast<ViewId>(i));
     }
+#else
+    // Other views are created on first navigation
+    const char *mode = "lazy";
+    ensure_view(ViewProcessSelection);
+#endif
+
+    FURI_LOG_I(APP_TAG, "Views ready (%s) in %lu ms, heap used %u, free %u",
+               mode, static_cast<unsigned long>(furi_get_tick() - start),
+               static_cast<unsigned>(heap_before - memmgr_get_free_heap()),
+               static_cast<unsigned>(memmgr_get_free_heap()));
   }
 
   void send_custom_event(FilmDeveloperEvent event) {
-    if (event == FilmDeveloperEvent::TimerTick) {
+    if (event == FilmDeveloperEvent::TimerTick ||
+        event == FilmDeveloperEvent::ProcessTick) {
       FURI_LOG_T(APP_TAG, "Sending timer tick event");
     } else {
       FURI_LOG_D(APP_TAG, "Sending custom event: %s", get_event_name(event));
@@ -172,60 +281,205 @@ public:
     view_dispatcher_run(view_dispatcher);
   }
 
+  // Runs in the timer service thread: only hand the tick over to the
+  // dispatcher thread, which owns the model and the views.
   static void timer_callback(void *context) {
     auto app = static_cast<FilmDeveloperApp *>(context);
-    app->update();
+    app->send_custom_event(FilmDeveloperEvent::ProcessTick);
   }
 
-  int ticks = 0;
-
-  void update() {
-    auto model = this->model.lock();
-    if (model->is_process_active() && !model->is_process_paused()) {
-      auto *process_interpreter = model->process_interpreter;
-      const bool wasWaitingForUser = process_interpreter->isWaitingForUser();
-      bool still_active = process_interpreter->tick();
-      const bool isWaitingForUser = process_interpreter->isWaitingForUser();
-      if (!wasWaitingForUser && isWaitingForUser) {
-        send_custom_event(FilmDeveloperEvent::UserActionRequired);
-      }
+  // Runs in the input service thread, same hand-over as the timer
+  static void input_callback(const void *message, void *context) {
+    auto event = static_cast<const InputEvent *>(message);
+    if (event->type != InputTypePress) {
+      return;
+    }
+    auto app = static_cast<FilmDeveloperApp *>(context);
+    app->send_custom_event(FilmDeveloperEvent::UserActivity);
+  }
 
-      FURI_LOG_T(
-          APP_TAG, "Process tick - Step: %d, Time: %ld/%ld",
-          process_interpreter->getCurrentStepIndex(),
-          static_cast<long>(
-              process_interpreter->getCurrentMovementTimeElapsed()),
-          static_cast<long>(process_interpreter->getCurrentMovementDuration()));
+  void update(Model &model) {
+    PROFILE_SCOPE("App update");
+    last_tick_at = furi_get_tick();
+    if (!model.is_process_active() || model.is_process_paused()) {
+      // Nothing advances while idle or paused: no tick, no redraw
+      wake_display();
+      return;
+    }
 
-      model->update();
+    {
+      StackProbe probe("Process tick");
+      model.process_interpreter->tick();
+    }
+    drain_process_events(model);
+    if (model.is_process_active()) {
+      schedule_tick(model);
+    }
+    if (apply_display_policy(model)) {
+      send_custom_event(FilmDeveloperEvent::TimerTick);
+    }
+  }
 
-      if (!still_active && process_interpreter->isComplete()) {
-        model->complete_process();
-        FURI_LOG_I(APP_TAG, "Process completed");
+  // Handles everything the interpreter reported since the last wakeup. The
+  // step and movement texts are only rebuilt when an event touched them.
+  void drain_process_events(Model &model) {
+    bool texts_changed = false;
+    bool completed = false;
+
+    ProcessEvent event;
+    while (process_events.pop(event)) {
+      FURI_LOG_D(APP_TAG, "Process event: %s (%lu)",
+                 ProcessEvent::get_type_name(event.type),
+                 static_cast<unsigned long>(event.value));
+      switch (event.type) {
+      case ProcessEvent::Type::StepStarted:
+      case ProcessEvent::Type::MovementChanged:
+        display_policy.note_activity(last_tick_at);
+        texts_changed = true;
+        break;
+      case ProcessEvent::Type::MotorDirectionChanged:
+        texts_changed = true;
+        break;
+      case ProcessEvent::Type::UserActionRequired:
+        display_policy.note_activity(last_tick_at);
+        send_custom_event(FilmDeveloperEvent::UserActionRequired);
+        break;
+      case ProcessEvent::Type::ProcessCompleted:
+        completed = true;
+        break;
       }
     }
 
-    send_custom_event(FilmDeveloperEvent::TimerTick);
+    if (completed) {
+      model.complete_process();
+      // Resetting the interpreter reports its own state changes, which
+      // belong to no running process
+      process_events.clear();
+      FURI_LOG_I(APP_TAG, "Process completed");
+      return;
+    }
+
+    if (texts_changed) {
+      model.update();
+    } else {
+      model.update_time();
+    }
   }
 
 private:
+#ifdef FILM_DEV_STATIC_STORAGE
+  static StaticSlot<MotorControllerImpl, MOTOR_CONTROLLER_BUDGET>
+      motor_controller_slot;
+  static StaticSlot<ProcessInterpreterImpl, PROCESS_INTERPRETER_BUDGET>
+      process_interpreter_slot;
+  static StaticSlot<ProcessLibrary, PROCESS_LIBRARY_BUDGET> process_library_slot;
+
+  static MotorController *create_motor_controller() {
+    HeapProbe probe("Motor controller");
+    return motor_controller_slot.construct();
+  }
+
+  static ProcessInterpreterInterface *
+  create_process_interpreter(MotorController *motor) {
+    HeapProbe probe("Interpreter");
+    return process_interpreter_slot.construct(
+        *static_cast<MotorControllerImpl *>(motor));
+  }
+
+  static void destroy_motor_controller(MotorController *) {
+    motor_controller_slot.destroy();
+  }
+
+  static void destroy_process_interpreter(ProcessInterpreterInterface *) {
+    process_interpreter_slot.destroy();
+  }
+
+  static ProcessLibrary *create_process_library() {
+    HeapProbe probe("Process library");
+    return process_library_slot.construct();
+  }
+
+  static void destroy_process_library(ProcessLibrary *) {
+    process_library_slot.destroy();
+  }
+#else
+  static MotorController *create_motor_controller() {
+    HeapProbe probe("Motor controller");
+    return new MotorControllerImpl();
+  }
+
+  static ProcessInterpreterInterface *
+  create_process_interpreter(MotorController *motor) {
+    HeapProbe probe("Interpreter");
+    return new ProcessInterpreterImpl(
+        *static_cast<MotorControllerImpl *>(motor));
+  }
+
+  static void destroy_motor_controller(MotorController *motor) {
+    delete motor;
+  }
+
+  static void destroy_process_interpreter(ProcessInterpreterInterface *interpreter) {
+    delete interpreter;
+  }
+
+  static ProcessLibrary *create_process_library() {
+    HeapProbe probe("Process library");
+    return new ProcessLibrary();
+  }
+
+  static void destroy_process_library(ProcessLibrary *library) {
+    delete library;
+  }
+#endif
+
   static ViewMap view_map[ViewCount];
   Gui *gui = nullptr;
   ViewDispatcher *view_dispatcher = nullptr;
   ViewId current_view = ViewProcessSelection;
 
+  // The countdown on screen moves once a second, in between the timer only
+  // wakes the app for the motor and the end of a step
+  static constexpr uint32_t UI_TICK_MS = 1000;
+
+  FuriTimer *tick_timer = nullptr;
+  // Tick time of the last update, when the next countdown refresh is due,
+  // and how much of that second was left when the process was paused.
+  uint32_t last_tick_at = 0;
+  uint32_t ui_tick_due = 0;
+  uint32_t paused_ui_ms = 0;
+
+  NotificationApp *notifications = nullptr;
+  FuriPubSub *input_events = nullptr;
+  FuriPubSubSubscription *input_subscription = nullptr;
+  DisplayPolicy display_policy;
+
   ProtectedModel model;
+  ProcessEventQueue process_events;
+  TemperatureSourceImpl temperature_source;
+  TemperatureSampler<> temperature_sampler{temperature_source};
+#ifdef FILM_DEV_HEATER
+#ifdef HOST
+  HeaterOutput &heater_output{temperature_source};
+#else
+  HeaterOutputImpl heater_output;
+#endif
+  HeaterController heater{heater_output, temperature_sampler.getFeed()};
+#endif
   MotorController *motor_controller{nullptr};
   ProcessInterpreterInterface *process_interpreter{nullptr};
+  Storage *storage{nullptr};
+  ProcessLibrary *process_library{nullptr};
 
   // Views
   MainDevelopmentView main_view{model};
-  ProcessSelectionView process_view{process_interpreter};
+  ProcessSelectionView process_view;
   SettingsView settings_view{model};
   ConfirmationDialogView dialog_view;
   DispatchMenuView dispatch_menu_view;
   RuntimeSettingsView runtime_settings_view;
   PausedView paused_view{model};
+  DebugStatsView debug_stats_view;
 
   AppState current_state{AppState::ProcessSelection};
   AppState before_confirmation_state{AppState::ProcessSelection};
@@ -233,18 +487,99 @@ private:
 
   static bool custom_callback(void *context, uint32_t event) {
     auto app = static_cast<FilmDeveloperApp *>(context);
-    return app->handle_custom_event(static_cast<FilmDeveloperEvent>(event));
+    return app->dispatch(app_state_machine::trigger_for(event));
   }
 
   static bool navigation_callback(void *context) {
     FURI_LOG_D(APP_TAG, "Navigation callback");
     auto app = static_cast<FilmDeveloperApp *>(context);
-    return app->handle_back_event();
+    return app->dispatch(app_state_machine::TRIGGER_BACK);
+  }
+
+  // Restart the countdown second at the moment of a user action and
+  // evaluate the process right away, instead of waiting for the next tick.
+  void retick_now(Model &model) {
+    ui_tick_due = furi_get_tick() + UI_TICK_MS;
+    update(model);
+  }
+
+  void remember_pause_phase() {
+    uint32_t left = ui_tick_due - furi_get_tick();
+    paused_ui_ms = left <= UI_TICK_MS ? left : 0;
+  }
+
+  // Finish the countdown second that was interrupted by the pause
+  void resume_ticks(Model &model) {
+    ui_tick_due = furi_get_tick() + paused_ui_ms;
+    schedule_tick(model);
+    model.update();
+    send_custom_event(FilmDeveloperEvent::TimerTick);
+  }
+
+  // Arms the timer for whichever comes first: the interpreter's next motor
+  // change or step end, or the next countdown refresh. A stand phase thus
+  // wakes the app once a second instead of every 10 ms.
+  void schedule_tick(Model &model) {
+    uint32_t now = furi_get_tick();
+    if (static_cast<int32_t>(now - ui_tick_due) >= 0) {
+      ui_tick_due += UI_TICK_MS;
+      // Late by more than a second, e.g. after a long dialog
+      if (static_cast<int32_t>(now - ui_tick_due) >= 0) {
+        ui_tick_due = now + UI_TICK_MS;
+      }
+    }
+    uint32_t delay = ui_tick_due - now;
+    uint32_t next = model.process_interpreter->getTimeToNextEventMs();
+    if (next < delay) {
+      delay = next;
+    }
+    furi_timer_start(tick_timer, furi_ms_to_ticks(delay > 0 ? delay : 1));
+  }
+
+  // Picks the refresh rate and backlight for the current movement. Returns
+  // whether this tick should redraw the screen.
+  bool apply_display_policy(Model &model) {
+    uint32_t now = furi_get_tick();
+    if (!model.is_process_active()) {
+      wake_display();
+      return true;
+    }
+
+    bool motor_idle = !model.is_waiting_for_user() &&
+                      model.motor_controller->getDirection() ==
+                          MotorController::Direction::Stopped;
+    if (display_policy.evaluate(
+            now, motor_idle,
+            model.process_interpreter->getTimeInDirectionMs(),
+            model.process_interpreter->getTimeToNextEventMs())) {
+      set_backlight(display_policy.get_mode());
+      return true;
+    }
+    return display_policy.should_redraw(now);
+  }
+
+  // Returns true if the display was in low power mode
+  bool wake_display() {
+    if (!display_policy.wake(furi_get_tick())) {
+      return false;
+    }
+    set_backlight(DisplayPolicy::Mode::Active);
+    return true;
+  }
+
+  void set_backlight(DisplayPolicy::Mode mode) {
+    FURI_LOG_I(APP_TAG, "Display mode: %s",
+               DisplayPolicy::get_mode_name(mode));
+    notification_message(notifications,
+                         mode == DisplayPolicy::Mode::LowPower
+                             ? &sequence_display_backlight_off
+                             : &sequence_display_backlight_on);
   }
 
   void enter_state(AppState new_state) {
     FURI_LOG_D(APP_TAG, "State transition: %s -> %s",
-               get_state_name(current_state), get_state_name(new_state));
+               app_state_machine::get_state_name(current_state),
+               app_state_machine::get_state_name(new_state));
 
     current_state = new_state;
   }
@@ -258,6 +593,9 @@ private:
       return false;
     }
 
+    ensure_view(new_view_id);
+    ViewId previous_view = current_view;
+
     // if (current) {
     //   current->exit();
     // }
@@ -268,343 +606,488 @@ private:
 
     current_view = new_view_id;
     view_dispatcher_switch_to_view(view_dispatcher, new_view_id);
+#ifdef FILM_DEV_RELEASE_VIEWS
+    release_view(previous_view);
+#else
+    UNUSED(previous_view);
+#endif
     return true;
   }
 
-  void
-  show_confirmation_dialog(ConfirmationDialogView::DialogType dialog_type) {
-    before_confirmation_state = current_state;
-    before_confirmation_view = current_view;
-    dialog_view.show_dialog(dialog_type);
-    switch_to_view(ViewConfirmationDialog);
+  // Creates the view and registers it with the dispatcher on first use
+  void ensure_view(ViewId id) {
+    flipper::ViewCpp *view = view_map[id].view;
+    if (view->is_initialized()) {
+      return;
+    }
+    size_t heap_before = memmgr_get_free_heap();
+    {
+      StackProbe probe("View init");
+      view->set_view_dispatcher(view_dispatcher);
+      view->init();
+      view_dispatcher_add_view(view_dispatcher, id, view->get_view());
+    }
+    MemoryStats::record_heap(view_map[id].name, heap_before,
+                             memmgr_get_free_heap());
+    FURI_LOG_D(APP_TAG, "Created view %s, %u bytes", view_map[id].name,
+               static_cast<unsigned>(heap_before - memmgr_get_free_heap()));
   }
 
-  void show_exit_confirmation_dialog() {
-    show_confirmation_dialog(ConfirmationDialogView::DialogType::AppExit);
-    enter_state(AppState::ConfirmExit);
+#ifdef FILM_DEV_RELEASE_VIEWS
+  // Frees a transient view that is no longer shown
+  void release_view(ViewId id) {
+    flipper::ViewCpp *view = view_map[id].view;
+    if (!view_map[id].transient || id == current_view ||
+        !view->is_initialized()) {
+      return;
+    }
+    size_t heap_before = memmgr_get_free_heap();
+    view_dispatcher_remove_view(view_dispatcher, id);
+    view->deinit();
+    FURI_LOG_D(APP_TAG, "Released view %s, %u bytes", view_map[id].name,
+               static_cast<unsigned>(memmgr_get_free_heap() - heap_before));
   }
+#endif
 
-  void show_restart_confirmation_dialog() {
-    show_confirmation_dialog(ConfirmationDialogView::DialogType::StepRestart);
-    enter_state(AppState::ConfirmRestart);
-  }
+  //----------------------------------------------------------------------------
+  // State machine
+  //----------------------------------------------------------------------------
 
-  void show_waiting_confirmation_dialog() {
-    show_confirmation_dialog(ConfirmationDialogView::DialogType::StepComplete);
-    enter_state(AppState::WaitingConfirmation);
-  }
+  using Guard = app_state_machine::Guard<Model>;
+  using Action = app_state_machine::Action<FilmDeveloperApp, Model>;
+  using Rule = app_state_machine::Rule<FilmDeveloperApp, Model>;
 
-  void show_skip_confirmation_dialog() {
-    show_confirmation_dialog(ConfirmationDialogView::DialogType::StepSkip);
-    enter_state(AppState::ConfirmSkip);
-  }
+  static const Rule RULES[];
+  static const app_state_machine::TransitionTable TRANSITIONS;
 
-  void show_stop_confirmation_dialog() {
-    show_confirmation_dialog(ConfirmationDialogView::DialogType::ProcessAbort);
-    enter_state(AppState::ConfirmStop);
+  static constexpr ViewId view_for(AppState state) {
+    switch (state) {
+    case AppState::ProcessSelection:
+      return ViewProcessSelection;
+    case AppState::Settings:
+      return ViewSettings;
+    case AppState::MainView:
+      return ViewMainDevelopment;
+    case AppState::Paused:
+      return ViewPaused;
+    case AppState::RuntimeSettings:
+      return ViewRuntimeSettings;
+    case AppState::DispatchDialog:
+      return ViewDispatchMenu;
+    case AppState::DebugStats:
+      return ViewDebugStats;
+    case AppState::WaitingConfirmation:
+    case AppState::ConfirmRestart:
+    case AppState::ConfirmSkip:
+    case AppState::ConfirmStop:
+    case AppState::ConfirmExit:
+      return ViewConfirmationDialog;
+    }
+    return ViewProcessSelection;
   }
 
-  void show_main_view(bool paused = false) {
-    if (paused) {
-      enter_state(AppState::Paused);
-      switch_to_view(ViewPaused);
+  // Looks up the rules for the current state and trigger, and applies the
+  // first one whose guard passes. The model stays locked for the whole
+  // transition.
+  bool dispatch(uint8_t trigger) {
+    if (trigger == app_state_machine::NO_TRIGGER) {
+      FURI_LOG_W(APP_TAG, "Unknown event, ignoring");
+      return false;
     }
-    enter_state(AppState::MainView);
-    switch_to_view(ViewMainDevelopment);
-  }
 
-  bool handle_back_event() {
-    FURI_LOG_D(APP_TAG, "Back event");
-    auto model = this->model.lock();
-    FURI_LOG_D(APP_TAG, "Model locked, Process active: %d",
-               model->is_process_active());
-    switch (current_state) {
-    case AppState::ProcessSelection:
-      show_exit_confirmation_dialog();
-      //   // Only allow exit to menu if no process is active
-      //   if (!model->is_process_active()) {
-      //     FURI_LOG_D(APP_TAG, "No process active, stopping view
-      //     dispatcher"); view_dispatcher_stop(view_dispatcher); return true;
-      //   }
-      //   FURI_LOG_D(APP_TAG, "Process active, staying in state");
-      //   return false;
-      return true;
+    if (trigger == app_state_machine::trigger_for(
+                       FilmDeveloperEvent::ProcessTick) ||
+        trigger ==
+            app_state_machine::trigger_for(FilmDeveloperEvent::TimerTick)) {
+      FURI_LOG_T(APP_TAG, "Timer tick event, current state: %s",
+                 app_state_machine::get_state_name(current_state));
+    } else {
+      FURI_LOG_D(APP_TAG, "Event received: %s, current state: %s",
+                 app_state_machine::get_trigger_name(trigger),
+                 app_state_machine::get_state_name(current_state));
+    }
 
-    case AppState::Paused:
-      // Resume process when back is pressed from paused view
-      // XXX should show stop confirmation dialog
-      if (model->resume_process()) {
-        enter_state(AppState::MainView);
-        return switch_to_view(ViewMainDevelopment);
+    auto model = this->model.lock();
+    const uint8_t *cell =
+        TRANSITIONS.cells[static_cast<size_t>(current_state)][trigger];
+    for (size_t i = 0; i < app_state_machine::RULES_PER_CELL; i++) {
+      if (cell[i] == app_state_machine::NO_RULE) {
+        break;
       }
-      return true;
-
-    case AppState::MainView:
-      if (model->is_process_active()) {
-        show_stop_confirmation_dialog();
-      } else {
-        enter_state(AppState::ProcessSelection);
-        return switch_to_view(ViewProcessSelection);
+      const Rule &rule = RULES[cell[i]];
+      if (rule.guard.test != nullptr && !rule.guard.test(*model)) {
+        continue;
       }
-      return true;
+      bool handled = apply(rule, *model);
+      update_heater_target(*model);
+      return handled;
+    }
 
-    case AppState::RuntimeSettings:
-    case AppState::DispatchDialog:
-      if (model->is_process_paused()) {
-        enter_state(AppState::Paused);
-        return switch_to_view(ViewPaused);
-      }
-      enter_state(AppState::MainView);
-      return switch_to_view(ViewMainDevelopment);
+    // The table is built so that every cell ends with an unguarded rule
+    furi_assert(false);
+    return false;
+  }
 
-    case AppState::ConfirmExit:
-    case AppState::ConfirmRestart:
-    case AppState::ConfirmSkip:
-    case AppState::ConfirmStop:
-      if (model->is_process_paused()) {
-        enter_state(AppState::Paused);
-        return switch_to_view(ViewPaused);
-      }
-      enter_state(before_confirmation_state);
-      return switch_to_view(before_confirmation_view);
+  bool apply(const Rule &rule, Model &model) {
+    using app_state_machine::TargetKind;
 
-    case AppState::Settings:
-      enter_state(AppState::ProcessSelection);
-      return switch_to_view(ViewProcessSelection);
+    if (rule.target.kind == TargetKind::Pass) {
+      return false;
+    }
+    if (rule.action.run != nullptr && !rule.action.run(*this, model)) {
+      return true;
+    }
 
-    case AppState::WaitingConfirmation:
+    switch (rule.target.kind) {
+    case TargetKind::Enter:
+      enter_state(rule.target.state);
+      return switch_to_view(view_for(rule.target.state));
+    case TargetKind::Return:
       enter_state(before_confirmation_state);
       return switch_to_view(before_confirmation_view);
+    case TargetKind::Pass:
+    case TargetKind::Stay:
+      break;
     }
+    return true;
+  }
 
-    furi_assert(false);
-    return false;
+  // The heater is mains powered and may run unattended, so it only heats
+  // for a process the user started. Stopping, completing or resetting the
+  // process, which also happens on the way back to the selection, turns it
+  // off. Called after every event, so a changed temperature follows too.
+  void update_heater_target(const Model &model) {
+#ifdef FILM_DEV_HEATER
+    heater.setTarget(model.is_process_active()
+                         ? model.process_interpreter->getTargetCelsius()
+                         : NAN);
+#else
+    UNUSED(model);
+#endif
   }
 
   flipper::ViewCpp *get_view(ViewId id) { return view_map[id].view; }
 
-  bool handle_custom_event(FilmDeveloperEvent event) {
-    auto model = this->model.lock();
-    if (event == FilmDeveloperEvent::TimerTick) {
-      FURI_LOG_T(APP_TAG, "Timer tick event, current state: %s",
-                 get_state_name(current_state));
-    } else {
-      FURI_LOG_D(APP_TAG, "Custom event received: %s, current state: %s",
-                 get_event_name(event), get_state_name(current_state));
-    }
-
-    switch (event) {
-    case FilmDeveloperEvent::ProcessSelected:
-      enter_state(AppState::Settings);
-      return switch_to_view(ViewSettings);
-
-    case FilmDeveloperEvent::SettingsConfirmed:
-      model->set_process(process_view.get_selected_process());
-      enter_state(AppState::MainView);
-      return switch_to_view(ViewMainDevelopment);
-
-    case FilmDeveloperEvent::PauseRequested:
-      if (current_state == AppState::MainView ||
-          current_state == AppState::DispatchDialog) {
-        if (model->pause_process()) {
-          enter_state(AppState::Paused);
-          return switch_to_view(ViewPaused);
-        }
-      }
-      return true;
-
-    case FilmDeveloperEvent::ResumeRequested:
-      if (current_state == AppState::Paused ||
-          current_state == AppState::DispatchDialog) {
-        if (model->resume_process()) {
-          enter_state(AppState::MainView);
-          return switch_to_view(ViewMainDevelopment);
-        }
-      }
-      return true;
+  // Remembers where the dialog was opened from; the rule's target then
+  // switches to the dialog view.
+  void open_dialog(ConfirmationDialogView::DialogType dialog_type) {
+    before_confirmation_state = current_state;
+    before_confirmation_view = current_view;
+    ensure_view(ViewConfirmationDialog);
+    dialog_view.show_dialog(dialog_type);
+  }
 
-    case FilmDeveloperEvent::EnterRuntimeSettings:
-      enter_state(AppState::RuntimeSettings);
-      return switch_to_view(ViewRuntimeSettings);
+  // Guards
 
-    case FilmDeveloperEvent::ExitRuntimeSettings:
-      if (model->is_process_paused()) {
-        enter_state(AppState::Paused);
-        return switch_to_view(ViewPaused);
-      }
-      enter_state(AppState::MainView);
-      return switch_to_view(ViewMainDevelopment);
-
-    case FilmDeveloperEvent::UserActionRequired:
-      // XXX not the cleanest way to do this, we should delegate entirely to
-      // the process interpreter
-      if (model->wait_for_user()) {
-        show_waiting_confirmation_dialog();
-        return true;
-      }
-      return true;
+  static bool is_process_active(const Model &model) {
+    return model.is_process_active();
+  }
 
-    case FilmDeveloperEvent::UserActionConfirmed:
-      if (model->confirm_user_action()) {
-        enter_state(before_confirmation_state);
-        return switch_to_view(before_confirmation_view);
-      }
-      return true;
+  static bool is_process_paused(const Model &model) {
+    return model.is_process_paused();
+  }
 
-    case FilmDeveloperEvent::RestartRequested:
-      // NOTE not sure we need to check for the current state here, or maybe
-      // check for it negatively.
-      if (current_state == AppState::MainView ||
-          current_state == AppState::Paused ||
-          current_state == AppState::DispatchDialog) {
-        show_restart_confirmation_dialog();
-      } else {
-        FURI_LOG_I(APP_TAG,
-                   "Restart requested, but not in a valid state, ignoring");
-      }
-      return true;
+  // Actions
 
-    case FilmDeveloperEvent::SkipRequested:
-      if (current_state == AppState::MainView ||
-          current_state == AppState::Paused ||
-          current_state == AppState::DispatchDialog) {
-        show_skip_confirmation_dialog();
-      }
-      return true;
+  static bool open_exit_dialog(FilmDeveloperApp &app, Model &) {
+    app.open_dialog(ConfirmationDialogView::DialogType::AppExit);
+    return true;
+  }
 
-    case FilmDeveloperEvent::StopProcessRequested:
-      show_stop_confirmation_dialog();
-      return true;
+  static bool open_restart_dialog(FilmDeveloperApp &app, Model &) {
+    app.open_dialog(ConfirmationDialogView::DialogType::StepRestart);
+    return true;
+  }
 
-    case FilmDeveloperEvent::ExitRequested:
-      show_exit_confirmation_dialog();
-      return true;
+  static bool open_skip_dialog(FilmDeveloperApp &app, Model &) {
+    app.open_dialog(ConfirmationDialogView::DialogType::StepSkip);
+    return true;
+  }
 
-    case FilmDeveloperEvent::DispatchDialogRequested:
-      enter_state(AppState::DispatchDialog);
-      return switch_to_view(ViewDispatchMenu);
+  static bool open_stop_dialog(FilmDeveloperApp &app, Model &) {
+    app.open_dialog(ConfirmationDialogView::DialogType::ProcessAbort);
+    return true;
+  }
 
-    case FilmDeveloperEvent::RestartStep:
-      model->restart_current_step();
-      if (model->is_process_paused()) {
-        model->resume_process();
-      }
-      enter_state(AppState::MainView);
-      return switch_to_view(ViewMainDevelopment);
+  static bool wait_for_user(FilmDeveloperApp &app, Model &model) {
+    // XXX not the cleanest way to do this, we should delegate entirely to
+    // the process interpreter
+    if (!model.wait_for_user()) {
+      return false;
+    }
+    app.open_dialog(ConfirmationDialogView::DialogType::StepComplete);
+    return true;
+  }
 
-    case FilmDeveloperEvent::SkipStep:
-      model->process_interpreter->advanceToNextStep();
-      if (model->is_process_paused()) {
-        model->resume_process();
-      }
-      // XXX ideally we want to trigger a tick here, and restart the timer
-      enter_state(AppState::MainView);
-      return switch_to_view(ViewMainDevelopment);
-
-    case FilmDeveloperEvent::StopProcess:
-      model->stop_process();
-      enter_state(AppState::ProcessSelection);
-      return switch_to_view(ViewProcessSelection);
-
-    case FilmDeveloperEvent::DispatchDialogConfirmed:
-      switch (current_state) {
-      case AppState::ConfirmRestart: {
-        send_custom_event(FilmDeveloperEvent::RestartStep);
-        return true;
-      }
-      case AppState::ConfirmSkip: {
-        send_custom_event(FilmDeveloperEvent::SkipStep);
-        return true;
-      }
-      case AppState::ConfirmExit: {
-        send_custom_event(FilmDeveloperEvent::ExitRequested);
-        return true;
-      }
-      default:
-        return false;
-      }
+  static bool confirm_user_action(FilmDeveloperApp &app, Model &model) {
+    if (!model.confirm_user_action()) {
+      return false;
+    }
+    app.retick_now(model);
+    return true;
+  }
 
-    case FilmDeveloperEvent::DispatchDialogDismissed:
-      show_main_view(model->is_process_paused());
-      return true;
+  static bool show_settings(FilmDeveloperApp &app, Model &model) {
+    app.ensure_view(ViewSettings);
+    app.settings_view.sync(model);
+    return true;
+  }
 
-    case FilmDeveloperEvent::StartProcess:
-      if (model->start_process()) {
-        enter_state(AppState::MainView);
-        return switch_to_view(ViewMainDevelopment);
-      }
-      return true;
+  // Stays in the settings if the process cannot be loaded
+  static bool select_process(FilmDeveloperApp &app, Model &model) {
+    if (!model.set_process(app.process_view.get_selected_entry())) {
+      app.settings_view.show_load_error();
+      return false;
+    }
+    return true;
+  }
 
-    case FilmDeveloperEvent::ProcessCompleted:
-      if (model->complete_process()) {
-        enter_state(AppState::ProcessSelection);
-        return switch_to_view(ViewProcessSelection);
-      }
-      return true;
+  static bool start_process(FilmDeveloperApp &app, Model &model) {
+    if (!model.start_process()) {
+      return false;
+    }
+    app.retick_now(model);
+    return true;
+  }
 
-    case FilmDeveloperEvent::ExitApp:
-      view_dispatcher_stop(view_dispatcher);
-      return true;
-    case FilmDeveloperEvent::PauseProcess:
-    case FilmDeveloperEvent::ResumeProcess:
-    case FilmDeveloperEvent::StepComplete:
+  static bool pause_process(FilmDeveloperApp &app, Model &model) {
+    if (!model.pause_process()) {
       return false;
+    }
+    app.remember_pause_phase();
+    return true;
+  }
 
-    case FilmDeveloperEvent::TimerTick:
-    case FilmDeveloperEvent::MotorStateChanged:
-    case FilmDeveloperEvent::AgitationComplete:
-    case FilmDeveloperEvent::PushPullChanged:
-    case FilmDeveloperEvent::RollCountChanged:
-    case FilmDeveloperEvent::StepDurationChanged:
-    case FilmDeveloperEvent::StateChanged:
+  static bool resume_process(FilmDeveloperApp &app, Model &model) {
+    if (!model.resume_process()) {
       return false;
     }
+    app.resume_ticks(model);
+    return true;
+  }
 
-    furi_assert(false);
-    return false;
+  static bool restart_step(FilmDeveloperApp &app, Model &model) {
+    model.restart_current_step();
+    if (model.is_process_paused()) {
+      model.resume_process();
+    }
+    app.retick_now(model);
+    return true;
+  }
+
+  static bool skip_step(FilmDeveloperApp &app, Model &model) {
+    model.process_interpreter->advanceToNextStep();
+    if (model.is_process_paused()) {
+      model.resume_process();
+    }
+    app.retick_now(model);
+    return true;
+  }
+
+  static bool stop_process(FilmDeveloperApp &app, Model &model) {
+    model.stop_process();
+    app.process_events.clear();
+    return true;
+  }
+
+  static bool complete_process(FilmDeveloperApp &, Model &model) {
+    return model.complete_process();
+  }
+
+  static bool confirm_restart(FilmDeveloperApp &app, Model &) {
+    app.send_custom_event(FilmDeveloperEvent::RestartStep);
+    return true;
+  }
+
+  static bool confirm_skip(FilmDeveloperApp &app, Model &) {
+    app.send_custom_event(FilmDeveloperEvent::SkipStep);
+    return true;
+  }
+
+  static bool confirm_exit(FilmDeveloperApp &app, Model &) {
+    app.send_custom_event(FilmDeveloperEvent::ExitRequested);
+    return true;
+  }
+
+  static bool exit_app(FilmDeveloperApp &app, Model &) {
+    view_dispatcher_stop(app.view_dispatcher);
+    return true;
+  }
+
+  static bool process_tick(FilmDeveloperApp &app, Model &model) {
+    app.update(model);
+    return true;
+  }
+
+  static bool user_activity(FilmDeveloperApp &app, Model &model) {
+    // Show the state the slow refresh left out
+    if (app.wake_display() && model.is_process_active()) {
+      model.update();
+      app.send_custom_event(FilmDeveloperEvent::TimerTick);
+    }
+    return true;
+  }
+
+  static bool show_memory_stats(FilmDeveloperApp &app, Model &) {
+    app.debug_stats_view.show_page(DebugStatsView::Page::Memory);
+    return true;
+  }
+
+  static bool show_perf_stats(FilmDeveloperApp &app, Model &) {
+    app.debug_stats_view.show_page(DebugStatsView::Page::Perf);
+    return true;
+  }
+
+  static bool log_ignored(FilmDeveloperApp &app, Model &) {
+    FURI_LOG_I(APP_TAG, "Request ignored in state %s",
+               app_state_machine::get_state_name(app.current_state));
+    return true;
   }
 };
 
+#define GUARD(fn)                                                              \
+  FilmDeveloperApp::Guard { &FilmDeveloperApp::fn }
+#define ACTION(fn)                                                             \
+  FilmDeveloperApp::Action { &FilmDeveloperApp::fn }
+#define ALWAYS                                                                 \
+  FilmDeveloperApp::Guard { nullptr }
+#define NO_ACTION                                                              \
+  FilmDeveloperApp::Action { nullptr }
+
+using app_state_machine::ANY_STATE;
+using app_state_machine::in;
+using app_state_machine::pass;
+using app_state_machine::stay;
+using app_state_machine::to;
+using app_state_machine::to_previous;
+using app_state_machine::trigger_for;
+using app_state_machine::TRIGGER_BACK;
+
+// Rules are matched in order, so per-state rules come before the ANY_STATE
+// fallback for the same trigger.
+constexpr FilmDeveloperApp::Rule FilmDeveloperApp::RULES[] = {
+    // clang-format off
+    // Back key
+    {in(AppState::ProcessSelection), TRIGGER_BACK, ALWAYS, ACTION(open_exit_dialog), to(AppState::ConfirmExit)},
+    {in(AppState::Settings), TRIGGER_BACK, ALWAYS, NO_ACTION, to(AppState::ProcessSelection)},
+    // XXX should show stop confirmation dialog
+    {in(AppState::Paused), TRIGGER_BACK, ALWAYS, ACTION(resume_process), to(AppState::MainView)},
+    {in(AppState::MainView), TRIGGER_BACK, GUARD(is_process_active), ACTION(open_stop_dialog), to(AppState::ConfirmStop)},
+    {in(AppState::MainView), TRIGGER_BACK, ALWAYS, NO_ACTION, to(AppState::ProcessSelection)},
+    {in(AppState::WaitingConfirmation), TRIGGER_BACK, ALWAYS, NO_ACTION, to_previous()},
+    {in(AppState::RuntimeSettings, AppState::DispatchDialog, AppState::DebugStats, AppState::ConfirmExit, AppState::ConfirmRestart, AppState::ConfirmSkip, AppState::ConfirmStop),
+     TRIGGER_BACK, GUARD(is_process_paused), NO_ACTION, to(AppState::Paused)},
+    {in(AppState::RuntimeSettings, AppState::DispatchDialog, AppState::DebugStats), TRIGGER_BACK, ALWAYS, NO_ACTION, to(AppState::MainView)},
+    {in(AppState::ConfirmExit, AppState::ConfirmRestart, AppState::ConfirmSkip, AppState::ConfirmStop), TRIGGER_BACK, ALWAYS, NO_ACTION, to_previous()},
+
+    // Selection and setup
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ProcessSelected), ALWAYS, ACTION(show_settings), to(AppState::Settings)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::SettingsConfirmed), ALWAYS, ACTION(select_process), to(AppState::MainView)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StartProcess), ALWAYS, ACTION(start_process), to(AppState::MainView)},
+
+    // Pause and resume
+    {in(AppState::MainView, AppState::DispatchDialog), trigger_for(FilmDeveloperEvent::PauseRequested), ALWAYS, ACTION(pause_process), to(AppState::Paused)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::PauseRequested), ALWAYS, NO_ACTION, stay()},
+    {in(AppState::Paused, AppState::DispatchDialog), trigger_for(FilmDeveloperEvent::ResumeRequested), ALWAYS, ACTION(resume_process), to(AppState::MainView)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ResumeRequested), ALWAYS, NO_ACTION, stay()},
+
+    // Runtime settings and dispatch menu
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::EnterRuntimeSettings), ALWAYS, NO_ACTION, to(AppState::RuntimeSettings)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ExitRuntimeSettings), GUARD(is_process_paused), NO_ACTION, to(AppState::Paused)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ExitRuntimeSettings), ALWAYS, NO_ACTION, to(AppState::MainView)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::DispatchDialogRequested), ALWAYS, NO_ACTION, to(AppState::DispatchDialog)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::DebugStatsRequested), ALWAYS, ACTION(show_memory_stats), to(AppState::DebugStats)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::PerfStatsRequested), ALWAYS, ACTION(show_perf_stats), to(AppState::DebugStats)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::DispatchDialogDismissed), GUARD(is_process_paused), NO_ACTION, to(AppState::Paused)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::DispatchDialogDismissed), ALWAYS, NO_ACTION, to(AppState::MainView)},
+
+    // User confirmation of a wait step
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::UserActionRequired), ALWAYS, ACTION(wait_for_user), to(AppState::WaitingConfirmation)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::UserActionConfirmed), ALWAYS, ACTION(confirm_user_action), to_previous()},
+
+    // Confirmation dialogs
+    {in(AppState::MainView, AppState::Paused, AppState::DispatchDialog), trigger_for(FilmDeveloperEvent::RestartRequested), ALWAYS, ACTION(open_restart_dialog), to(AppState::ConfirmRestart)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::RestartRequested), ALWAYS, ACTION(log_ignored), stay()},
+    {in(AppState::MainView, AppState::Paused, AppState::DispatchDialog), trigger_for(FilmDeveloperEvent::SkipRequested), ALWAYS, ACTION(open_skip_dialog), to(AppState::ConfirmSkip)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::SkipRequested), ALWAYS, ACTION(log_ignored), stay()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StopProcessRequested), ALWAYS, ACTION(open_stop_dialog), to(AppState::ConfirmStop)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ExitRequested), ALWAYS, ACTION(open_exit_dialog), to(AppState::ConfirmExit)},
+    {in(AppState::ConfirmRestart), trigger_for(FilmDeveloperEvent::DispatchDialogConfirmed), ALWAYS, ACTION(confirm_restart), stay()},
+    {in(AppState::ConfirmSkip), trigger_for(FilmDeveloperEvent::DispatchDialogConfirmed), ALWAYS, ACTION(confirm_skip), stay()},
+    {in(AppState::ConfirmExit), trigger_for(FilmDeveloperEvent::DispatchDialogConfirmed), ALWAYS, ACTION(confirm_exit), stay()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::DispatchDialogConfirmed), ALWAYS, NO_ACTION, pass()},
+
+    // Process control
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::RestartStep), ALWAYS, ACTION(restart_step), to(AppState::MainView)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::SkipStep), ALWAYS, ACTION(skip_step), to(AppState::MainView)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StopProcess), ALWAYS, ACTION(stop_process), to(AppState::ProcessSelection)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ProcessCompleted), ALWAYS, ACTION(complete_process), to(AppState::ProcessSelection)},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ProcessTick), ALWAYS, ACTION(process_tick), stay()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ExitApp), ALWAYS, ACTION(exit_app), stay()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::UserActivity), ALWAYS, ACTION(user_activity), stay()},
+
+    // Notifications meant for the views
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::PauseProcess), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ResumeProcess), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StepComplete), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::TimerTick), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::MotorStateChanged), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::AgitationComplete), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::PushPullChanged), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::RollCountChanged), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StepDurationChanged), ALWAYS, NO_ACTION, pass()},
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::StateChanged), ALWAYS, NO_ACTION, pass()},
+    // Only reaches the app if the selection view was left mid-search, it
+    // resumes when the view is entered again
+    {ANY_STATE, trigger_for(FilmDeveloperEvent::ProcessSearchStep), ALWAYS, NO_ACTION, pass()},
+    // clang-format on
+};
+
+#undef GUARD
+#undef ACTION
+#undef ALWAYS
+#undef NO_ACTION
+
+// Fails to compile if any (state, trigger) pair is left without a rule
+constexpr app_state_machine::TransitionTable FilmDeveloperApp::TRANSITIONS =
+    app_state_machine::build_table(FilmDeveloperApp::RULES);
+
+#ifdef FILM_DEV_STATIC_STORAGE
+StaticSlot<FilmDeveloperApp::MotorControllerImpl,
+           FilmDeveloperApp::MOTOR_CONTROLLER_BUDGET>
+    FilmDeveloperApp::motor_controller_slot;
+StaticSlot<FilmDeveloperApp::ProcessInterpreterImpl,
+           FilmDeveloperApp::PROCESS_INTERPRETER_BUDGET>
+    FilmDeveloperApp::process_interpreter_slot;
+StaticSlot<ProcessLibrary, FilmDeveloperApp::PROCESS_LIBRARY_BUDGET>
+    FilmDeveloperApp::process_library_slot;
+#endif
+
 FilmDeveloperApp::ViewMap FilmDeveloperApp::view_map[ViewCount] = {
-    {
-        ViewProcessSelection,
-        nullptr,
-    },
-    {
-        ViewSettings,
-        nullptr,
-    },
-    {
-        ViewMainDevelopment,
-        nullptr,
-    },
-    {
-        ViewConfirmationDialog,
-        nullptr,
-    },
-    {
-        ViewDispatchMenu,
-        nullptr,
-    },
-    {
-        ViewRuntimeSettings,
-        nullptr,
-    },
-    {
-        ViewPaused,
-        nullptr,
-    },
+    {ViewProcessSelection, nullptr, "ProcessSelection", false},
+    {ViewSettings, nullptr, "Settings", true},
+    {ViewMainDevelopment, nullptr, "MainDevelopment", false},
+    {ViewConfirmationDialog, nullptr, "ConfirmationDialog", true},
+    {ViewDispatchMenu, nullptr, "DispatchMenu", true},
+    {ViewRuntimeSettings, nullptr, "RuntimeSettings", true},
+    {ViewPaused, nullptr, "Paused", false},
+    {ViewDebugStats, nullptr, "DebugStats", true},
 };
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// The app object itself stays off the 2 KB app stack, which the dispatcher
+// loop and the update() and tick() frames need, and off the heap
+static StaticSlot<FilmDeveloperApp, FilmDeveloperApp::APP_BUDGET> app_slot;
+
 int32_t film_developer_app(void *p) {
   UNUSED(p);
-  FilmDeveloperApp app;
+  FilmDeveloperApp &app = *app_slot.construct();
   app.init();
   app.run();
+  app_slot.destroy();
   return 0;
 }
 
@@ -24,6 +24,7 @@ enum class FilmDeveloperEvent : uint32_t {
   // Timer Events
   TimerTick = 30,
   StepComplete = 31,
+  ProcessTick = 32,
 
   // Motor Control Events
   MotorStateChanged = 40,
@@ -53,6 +54,16 @@ enum class FilmDeveloperEvent : uint32_t {
   RestartRequested = 103,
   ExitRequested = 104,
   StopProcessRequested = 105,
+
+  // Display Events
+  UserActivity = 110,
+
+  // Diagnostics Events
+  DebugStatsRequested = 120,
+  PerfStatsRequested = 121,
+
+  // Process Selection Events
+  ProcessSearchStep = 130,
 };
 
 inline const char *get_event_name(FilmDeveloperEvent event) {
@@ -85,6 +96,8 @@ inline const char *get_event_name(FilmDeveloperEvent event) {
     return "TimerTick";
   case FilmDeveloperEvent::StepComplete:
     return "StepComplete";
+  case FilmDeveloperEvent::ProcessTick:
+    return "ProcessTick";
   case FilmDeveloperEvent::MotorStateChanged:
     return "MotorStateChanged";
   case FilmDeveloperEvent::AgitationComplete:
@@ -120,6 +133,14 @@ inline const char *get_event_name(FilmDeveloperEvent event) {
     return "ExitRequested";
   case FilmDeveloperEvent::StopProcessRequested:
     return "StopProcessRequested";
+  case FilmDeveloperEvent::UserActivity:
+    return "UserActivity";
+  case FilmDeveloperEvent::DebugStatsRequested:
+    return "DebugStatsRequested";
+  case FilmDeveloperEvent::PerfStatsRequested:
+    return "PerfStatsRequested";
+  case FilmDeveloperEvent::ProcessSearchStep:
+    return "ProcessSearchStep";
   }
 
   return "Unknown";
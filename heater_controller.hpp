@@ -0,0 +1,468 @@
+#pragma once
+
+#include "temperature_sensor.hpp"
+#include <atomic>
+#include <furi.h>
+#include <math.h>
+#include <stdint.h>
+
+#define HEATER_TAG "Heater"
+
+/**
+ * @brief Water bath heating.
+ *
+ * A HeaterController holds the bath at a target temperature: a PID loop on
+ * a thread of its own, woken at fixed deadlines, reads the TemperatureFeed
+ * and sets a HeaterOutput. The thread runs at low priority, so the motor
+ * timer and the GUI preempt it whenever they have work; a control step is a
+ * handful of float operations and never delays them.
+ *
+ * Relays only switch fully on or off. For them the controller proportions
+ * time instead: each period the relay is on for power times the period.
+ */
+
+/**
+ * @brief A heating element. setPower() is only called from the controller
+ * thread.
+ */
+class HeaterOutput {
+public:
+  virtual ~HeaterOutput() = default;
+
+  virtual bool begin() { return true; }
+  virtual void end() {}
+  // From 0, off, to 1, full power
+  virtual void setPower(float power) = 0;
+  virtual const char *getName() const = 0;
+  // true if the output is only ever fully on or off
+  virtual bool isSwitched() const { return true; }
+};
+
+/**
+ * @brief PID gains, for a power from 0 to 1 and degrees Celsius
+ */
+struct PidGains {
+  float kp; // Per degree of error
+  float ki; // Per degree second
+  float kd; // Per degree per second
+};
+
+/**
+ * @brief PID with the output clamped to 0..1.
+ *
+ * Anti-windup: the integral stops growing while the output is saturated in
+ * the direction the error pushes it, and is itself kept within 0..1, so a
+ * long warm-up doesn't leave a charge that overshoots the target. The
+ * derivative acts on the measurement, a target change doesn't kick it.
+ */
+class PidController {
+public:
+  explicit PidController(PidGains gains) : gains(gains) {}
+
+  void setGains(const PidGains &gains) { this->gains = gains; }
+  const PidGains &getGains() const { return gains; }
+
+  void reset() {
+    integral = 0;
+    primed = false;
+  }
+
+  float update(float target, float measurement, float dt_s) {
+    float error = target - measurement;
+    float proportional = gains.kp * error;
+    float derivative = 0;
+    if (primed && dt_s > 0) {
+      derivative = -gains.kd * (measurement - last_measurement) / dt_s;
+    }
+    last_measurement = measurement;
+    primed = true;
+
+    float accumulated = clamp(integral + gains.ki * error * dt_s);
+    float output = proportional + accumulated + derivative;
+    bool winding_up = (output > 1.0f && error > 0) || (output < 0 && error < 0);
+    if (!winding_up) {
+      integral = accumulated;
+    }
+    return clamp(proportional + integral + derivative);
+  }
+
+private:
+  static float clamp(float value) {
+    return value < 0 ? 0 : (value > 1.0f ? 1.0f : value);
+  }
+
+  PidGains gains;
+  float integral{0};
+  float last_measurement{0};
+  bool primed{false};
+};
+
+/**
+ * @brief Relay autotune after Åström and Hägglund.
+ *
+ * Switches full power on below the target and off above it, with a little
+ * hysteresis against noise. The bath settles into an oscillation whose
+ * period Tu and amplitude a give the ultimate gain Ku = 4 d / (pi a), d
+ * being half the power swing. Gains follow Tyreus-Luyben, which overshoots
+ * less than Ziegler-Nichols: a bath above its target only cools slowly.
+ */
+class RelayAutotuner {
+public:
+  // Oscillations measured, after the first one which still carries the
+  // warm-up
+  static constexpr uint8_t CYCLES = 3;
+  static constexpr float HYSTERESIS = 0.2f;
+  static constexpr uint32_t TIMEOUT_MS = 3 * 60 * 60 * 1000;
+
+  void start(uint32_t now_ms) {
+    started_at = now_ms;
+    heating = true;
+    cycles = 0;
+    period_sum_ms = 0;
+    amplitude_sum = 0;
+    highest = -INFINITY;
+    lowest = INFINITY;
+    done = false;
+    failed = false;
+  }
+
+  // Returns the power to apply
+  float update(float target, float measurement, uint32_t now_ms) {
+    if (done) {
+      return 0;
+    }
+    if (now_ms - started_at > TIMEOUT_MS) {
+      FURI_LOG_W(HEATER_TAG, "Autotune found no oscillation");
+      done = true;
+      failed = true;
+      return 0;
+    }
+
+    highest = measurement > highest ? measurement : highest;
+    lowest = measurement < lowest ? measurement : lowest;
+    if (heating && measurement > target + HYSTERESIS) {
+      heating = false;
+    } else if (!heating && measurement < target - HYSTERESIS) {
+      // A full oscillation ends where heating starts again
+      heating = true;
+      if (cycles > 0) {
+        period_sum_ms += now_ms - cycle_started_at;
+        amplitude_sum += (highest - lowest) / 2;
+      }
+      cycle_started_at = now_ms;
+      highest = measurement;
+      lowest = measurement;
+      if (cycles++ == CYCLES) {
+        finish();
+        return 0;
+      }
+    }
+    return heating ? 1.0f : 0;
+  }
+
+  bool isDone() const { return done; }
+  bool hasFailed() const { return failed; }
+  const PidGains &getGains() const { return gains; }
+
+private:
+  void finish() {
+    done = true;
+    float tu_s = period_sum_ms / 1000.0f / CYCLES;
+    float amplitude = amplitude_sum / CYCLES;
+    if (amplitude <= HYSTERESIS || tu_s <= 0) {
+      FURI_LOG_W(HEATER_TAG, "Autotune oscillation too small");
+      failed = true;
+      return;
+    }
+    // Half the power swing over the amplitude, less the hysteresis band
+    float ku = 4 * 0.5f /
+               (static_cast<float>(M_PI) *
+                sqrtf(amplitude * amplitude - HYSTERESIS * HYSTERESIS));
+    float kp = ku / 2.2f;
+    gains = PidGains{kp, kp / (2.2f * tu_s), kp * tu_s / 6.3f};
+    FURI_LOG_I(HEATER_TAG, "Autotune Ku %.3f Tu %.0f s: Kp %.3f Ki %.5f Kd %.2f",
+               static_cast<double>(ku), static_cast<double>(tu_s),
+               static_cast<double>(gains.kp), static_cast<double>(gains.ki),
+               static_cast<double>(gains.kd));
+  }
+
+  PidGains gains{0, 0, 0};
+  uint32_t started_at{0};
+  uint32_t cycle_started_at{0};
+  uint32_t period_sum_ms{0};
+  float amplitude_sum{0};
+  float highest{0};
+  float lowest{0};
+  uint8_t cycles{0};
+  bool heating{true};
+  bool done{false};
+  bool failed{false};
+};
+
+/**
+ * @brief Holds a water bath at a target temperature
+ */
+class HeaterController {
+public:
+  enum class Mode : uint8_t {
+    Off,
+    Holding,
+    Autotuning,
+  };
+
+  // Control and relay switching period
+  static constexpr uint32_t DEFAULT_PERIOD_MS = 5000;
+  // Shorter relay pulses are dropped or merged, sparing the contacts
+  static constexpr uint32_t MIN_SWITCH_MS = 250;
+  // The heater stays off with an older reading or further above the target
+  static constexpr uint32_t MAX_READING_AGE_MS = 5000;
+  static constexpr float MAX_OVERSHOOT = 3.0f;
+  // For a few litres of water and a few hundred watts, until autotuned
+  static constexpr PidGains DEFAULT_GAINS = {0.5f, 0.002f, 10.0f};
+
+  static const char *get_mode_name(Mode mode) {
+    switch (mode) {
+    case Mode::Off:
+      return "Off";
+    case Mode::Holding:
+      return "Holding";
+    case Mode::Autotuning:
+      return "Autotuning";
+    }
+    return "Unknown";
+  }
+
+  HeaterController(HeaterOutput &output, const TemperatureFeed &feed)
+      : output(output), feed(feed), pid(DEFAULT_GAINS) {}
+
+  ~HeaterController() { stop(); }
+
+  HeaterController(const HeaterController &) = delete;
+  HeaterController &operator=(const HeaterController &) = delete;
+
+  bool start() {
+    if (thread) {
+      return true;
+    }
+    if (!output.begin()) {
+      FURI_LOG_W(HEATER_TAG, "No %s heater", output.getName());
+      return false;
+    }
+    thread = furi_thread_alloc_ex("Heater", STACK_SIZE, run, this);
+    furi_thread_set_priority(thread, FuriThreadPriorityLow);
+    furi_thread_start(thread);
+    FURI_LOG_I(HEATER_TAG, "Controlling %s every %lu ms", output.getName(),
+               (unsigned long)DEFAULT_PERIOD_MS);
+    return true;
+  }
+
+  // Leaves the heater off
+  void stop() {
+    if (!thread) {
+      return;
+    }
+    furi_thread_flags_set(furi_thread_get_id(thread), FLAG_STOP);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    thread = nullptr;
+    output.end();
+  }
+
+  // NAN, or Mode::Off, leaves the heater off
+  void setTarget(float celsius) { target = celsius; }
+  float getTarget() const { return target.load(); }
+
+  void setMode(Mode mode) { requested_mode = mode; }
+  Mode getMode() const { return mode.load(); }
+
+  // Power applied this period, 0 to 1
+  float getPower() const { return power.load(); }
+
+  // Before start() or while off, the thread owns the gains otherwise
+  void setGains(const PidGains &gains) { pid.setGains(gains); }
+  const PidGains &getGains() const { return pid.getGains(); }
+
+  /**
+   * @brief One control step, returns the power for the coming period. The
+   * thread calls it every DEFAULT_PERIOD_MS, a host run on a SimulatedBath
+   * can call it directly.
+   */
+  float control(uint32_t now) {
+    Mode next = requested_mode.load();
+    if (next != mode.load()) {
+      FURI_LOG_I(HEATER_TAG, "%s", get_mode_name(next));
+      pid.reset();
+      if (next == Mode::Autotuning) {
+        autotuner.start(now);
+      }
+      mode = next;
+    }
+
+    float goal = target.load();
+    TemperatureReading reading = feed.read();
+    bool usable = reading.valid && now - reading.taken_at <=
+                                       furi_ms_to_ticks(MAX_READING_AGE_MS);
+    if (next == Mode::Off || isnan(goal) || !usable ||
+        reading.celsius > goal + MAX_OVERSHOOT) {
+      pid.reset();
+      return 0;
+    }
+
+    if (next == Mode::Autotuning) {
+      float applied = autotuner.update(goal, reading.celsius, now);
+      if (autotuner.isDone()) {
+        if (!autotuner.hasFailed()) {
+          pid.setGains(autotuner.getGains());
+        }
+        // Unless another mode was asked for meanwhile
+        Mode tuning = Mode::Autotuning;
+        requested_mode.compare_exchange_strong(tuning, Mode::Holding);
+      }
+      return applied;
+    }
+    return pid.update(goal, reading.celsius, DEFAULT_PERIOD_MS / 1000.0f);
+  }
+
+private:
+  static constexpr uint32_t STACK_SIZE = 1024;
+  static constexpr uint32_t FLAG_STOP = 1;
+
+  static int32_t run(void *context) {
+    static_cast<HeaterController *>(context)->loop();
+    return 0;
+  }
+
+  void loop() {
+    uint32_t period = furi_ms_to_ticks(DEFAULT_PERIOD_MS);
+    uint32_t min_switch = furi_ms_to_ticks(MIN_SWITCH_MS);
+    uint32_t period_start = furi_get_tick();
+    while (true) {
+      float applied = control(furi_get_tick());
+      power = applied;
+
+      if (output.isSwitched()) {
+        uint32_t on = static_cast<uint32_t>(applied * period + 0.5f);
+        on = on < min_switch ? 0 : (period - on < min_switch ? period : on);
+        output.setPower(on > 0 ? 1.0f : 0);
+        if (on > 0 && on < period) {
+          if (wait_until(period_start + on)) {
+            break;
+          }
+          output.setPower(0);
+        }
+      } else {
+        output.setPower(applied);
+      }
+
+      // Fixed deadlines, so the rate doesn't drift with the time spent
+      // above; after a stall, restart from now rather than catch up
+      period_start += period;
+      if (static_cast<int32_t>(furi_get_tick() - period_start) >
+          static_cast<int32_t>(period)) {
+        period_start = furi_get_tick();
+      }
+      if (wait_until(period_start)) {
+        break;
+      }
+    }
+    output.setPower(0);
+    power = 0;
+  }
+
+  // true if stop() was called
+  bool wait_until(uint32_t deadline) {
+    int32_t remaining = static_cast<int32_t>(deadline - furi_get_tick());
+    uint32_t flags = furi_thread_flags_wait(
+        FLAG_STOP, FuriFlagWaitAny, remaining > 0 ? remaining : 0);
+    return !(flags & FuriFlagError) && (flags & FLAG_STOP);
+  }
+
+  HeaterOutput &output;
+  const TemperatureFeed &feed;
+  PidController pid;
+  RelayAutotuner autotuner;
+  FuriThread *thread{nullptr};
+  std::atomic<float> target{NAN};
+  std::atomic<float> power{0};
+  std::atomic<Mode> requested_mode{Mode::Holding};
+  std::atomic<Mode> mode{Mode::Holding};
+};
+
+/**
+ * @brief Simulated water bath for host runs, heated and measured.
+ *
+ * The element warms the water through its own thermal mass and the probe
+ * follows the water with a lag, the two delays that make a real bath
+ * overshoot. The water loses heat to the room in proportion to the
+ * difference. Samples carry a little deterministic noise.
+ */
+class SimulatedBath final : public HeaterOutput, public TemperatureSource {
+public:
+  explicit SimulatedBath(float start_celsius = 20.0f,
+                         float room_celsius = 20.0f)
+      : water(start_celsius), element(start_celsius), probe(start_celsius),
+        room(room_celsius), lock(furi_mutex_alloc(FuriMutexTypeNormal)) {}
+
+  ~SimulatedBath() { furi_mutex_free(lock); }
+
+  SimulatedBath(const SimulatedBath &) = delete;
+  SimulatedBath &operator=(const SimulatedBath &) = delete;
+
+  void setPower(float power) override {
+    furi_mutex_acquire(lock, FuriWaitForever);
+    advance();
+    heater_power = power;
+    furi_mutex_release(lock);
+  }
+
+  bool sample(float &value) override {
+    furi_mutex_acquire(lock, FuriWaitForever);
+    advance();
+    // Linear congruential noise of about +-0.05 degrees
+    noise = noise * 1664525u + 1013904223u;
+    value = probe + (static_cast<float>(noise >> 24) / 255.0f - 0.5f) * 0.1f;
+    furi_mutex_release(lock);
+    return true;
+  }
+
+  const char *getName() const override { return "Simulated bath"; }
+
+private:
+  static constexpr float HEATER_WATTS = 300.0f;
+  // Three litres of water and a small element
+  static constexpr float WATER_JOULES_PER_DEGREE = 12500.0f;
+  static constexpr float ELEMENT_JOULES_PER_DEGREE = 400.0f;
+  static constexpr float ELEMENT_WATTS_PER_DEGREE = 20.0f;
+  static constexpr float LOSS_WATTS_PER_DEGREE = 3.0f;
+  static constexpr float PROBE_TIME_CONSTANT_S = 8.0f;
+  static constexpr float STEP_S = 0.1f;
+
+  // Integrates up to now in small steps, the caller holds the lock. Kernel
+  // ticks are milliseconds, as for FuriClock
+  void advance() {
+    uint32_t now = furi_get_tick();
+    float elapsed_s =
+        last_update == 0 ? 0 : static_cast<float>(now - last_update) / 1000.0f;
+    last_update = now;
+    while (elapsed_s > 0) {
+      float dt = elapsed_s < STEP_S ? elapsed_s : STEP_S;
+      float to_water = ELEMENT_WATTS_PER_DEGREE * (element - water);
+      element +=
+          (heater_power * HEATER_WATTS - to_water) / ELEMENT_JOULES_PER_DEGREE *
+          dt;
+      water += (to_water - LOSS_WATTS_PER_DEGREE * (water - room)) /
+               WATER_JOULES_PER_DEGREE * dt;
+      probe += (water - probe) * dt / PROBE_TIME_CONSTANT_S;
+      elapsed_s -= dt;
+    }
+  }
+
+  float water;
+  float element;
+  float probe;
+  float room;
+  float heater_power{0};
+  uint32_t last_update{0};
+  uint32_t noise{1};
+  FuriMutex *lock;
+};
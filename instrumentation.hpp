@@ -0,0 +1,513 @@
+#pragma once
+
+#include <atomic>
+#include <furi.h>
+#include <stddef.h>
+#include <stdint.h>
+#ifdef HOST
+#include <time.h>
+#else
+#include <furi_hal.h>
+#endif
+
+#define TAG_MEMORY_STATS "MemoryStats"
+#define TAG_PERF_STATS "PerfStats"
+
+/**
+ * @brief Process-wide memory statistics: heap cost of each subsystem's init
+ * and stack depth of probed code paths.
+ *
+ * Everything is recorded from the app thread, so there is no locking. The
+ * tables are small and fixed: records beyond their capacity are dropped.
+ * The debug view reads them from the GUI thread and may see a record
+ * mid-update.
+ */
+class MemoryStats {
+public:
+  static constexpr size_t MAX_RECORDS = 12;
+
+  struct HeapRecord {
+    const char *name;
+    int32_t used; // bytes taken from the heap by the init, negative if freed
+    size_t free_after;
+  };
+
+  struct StackRecord {
+    const char *name;
+    size_t peak; // deepest stack use seen, in bytes, see StackProbe
+  };
+
+  static void record_heap(const char *name, size_t free_before,
+                          size_t free_after) {
+    HeapRecord *record = find_or_add(heap_records, heap_count, name);
+    if (record != nullptr) {
+      record->used += static_cast<int32_t>(free_before) -
+                      static_cast<int32_t>(free_after);
+      record->free_after = free_after;
+    }
+  }
+
+  static void record_stack(const char *name, size_t used) {
+    StackRecord *record = find_or_add(stack_records, stack_count, name);
+    if (record != nullptr && used > record->peak) {
+      record->peak = used;
+    }
+  }
+
+  // Smallest amount of stack the calling thread ever had left, from the
+  // FreeRTOS stack fill pattern
+  static size_t thread_stack_free() {
+    return furi_thread_get_stack_space(furi_thread_get_current_id());
+  }
+
+  // Called on the app thread, before anything reads app_stack_free()
+  static void set_app_thread(FuriThreadId thread) { app_thread = thread; }
+
+  // The same for the app thread, from any thread: the debug view draws on
+  // the GUI thread, whose stack is not the one that is short
+  static size_t app_stack_free() {
+    FuriThreadId thread = app_thread.load();
+    return thread != nullptr ? furi_thread_get_stack_space(thread) : 0;
+  }
+
+  static size_t get_heap_count() { return heap_count; }
+  static const HeapRecord &get_heap(size_t i) { return heap_records[i]; }
+  static size_t get_stack_count() { return stack_count; }
+  static const StackRecord &get_stack(size_t i) { return stack_records[i]; }
+
+  static void log_all() {
+    FURI_LOG_I(TAG_MEMORY_STATS, "App stack: %lu bytes never used",
+               static_cast<unsigned long>(app_stack_free()));
+    for (size_t i = 0; i < stack_count; i++) {
+      FURI_LOG_I(TAG_MEMORY_STATS, "Stack %s: peak %lu bytes at most",
+                 stack_records[i].name,
+                 static_cast<unsigned long>(stack_records[i].peak));
+    }
+    FURI_LOG_I(TAG_MEMORY_STATS, "Heap: %lu free, %lu minimum",
+               static_cast<unsigned long>(memmgr_get_free_heap()),
+               static_cast<unsigned long>(memmgr_get_minimum_free_heap()));
+    for (size_t i = 0; i < heap_count; i++) {
+      FURI_LOG_I(TAG_MEMORY_STATS, "Heap %s: %ld bytes, %lu free after",
+                 heap_records[i].name,
+                 static_cast<long>(heap_records[i].used),
+                 static_cast<unsigned long>(heap_records[i].free_after));
+    }
+  }
+
+private:
+  template <typename Record>
+  static Record *find_or_add(Record *records, size_t &count,
+                             const char *name) {
+    for (size_t i = 0; i < count; i++) {
+      if (records[i].name == name) {
+        return &records[i];
+      }
+    }
+    if (count == MAX_RECORDS) {
+      return nullptr;
+    }
+    records[count] = Record{};
+    records[count].name = name;
+    return &records[count++];
+  }
+
+  static inline HeapRecord heap_records[MAX_RECORDS];
+  static inline size_t heap_count = 0;
+  static inline StackRecord stack_records[MAX_RECORDS];
+  static inline size_t stack_count = 0;
+  static inline std::atomic<FuriThreadId> app_thread{nullptr};
+};
+
+/**
+ * @brief Records the heap taken by an init, from construction to destruction
+ */
+class HeapProbe {
+public:
+  explicit HeapProbe(const char *name)
+      : name(name), free_before(memmgr_get_free_heap()) {}
+  ~HeapProbe() {
+    MemoryStats::record_heap(name, free_before, memmgr_get_free_heap());
+  }
+
+private:
+  const char *name;
+  size_t free_before;
+};
+
+/**
+ * @brief Measures how deep the stack goes below the probe's frame.
+ *
+ * On construction the unused stack below the caller is painted with a fill
+ * pattern. On destruction the lowest overwritten byte gives the depth that
+ * the code in between reached. The paint depth is capped by the thread's
+ * remaining stack space.
+ *
+ * The depth is an upper bound. An interrupt or a context switch that
+ * catches the thread stacks the registers on the thread's own stack: the
+ * hardware frame of up to 26 words with the FPU state, then the scheduler's
+ * r4-r11 and s16-s31. Landing below the deepest call, that is up to
+ * EXCEPTION_FRAME bytes more than the code itself used. Nested interrupts
+ * run on the main stack and add nothing. The thread needs that room anyway,
+ * so the bound is the number to budget the stack with.
+ */
+class StackProbe {
+public:
+  static constexpr size_t PAINT_DEPTH = 768;
+  static constexpr size_t SAFETY_MARGIN = 64;
+  // Hardware frame with the FPU state, then r4-r11, EXC_RETURN and s16-s31
+  // as the FreeRTOS port saves them on a context switch
+  static constexpr size_t EXCEPTION_FRAME = (26 + 8 + 1 + 16) * 4;
+
+  explicit StackProbe(const char *name) : name(name) { paint(); }
+  ~StackProbe() { MemoryStats::record_stack(name, measure()); }
+
+private:
+  static constexpr uint8_t FILL = 0xA5;
+
+  const char *name;
+  uintptr_t top = 0;
+  size_t depth = 0;
+
+  __attribute__((noinline)) void paint() {
+    volatile uint8_t marker = 0;
+    top = reinterpret_cast<uintptr_t>(&marker);
+    size_t available = MemoryStats::thread_stack_free();
+    depth = available > SAFETY_MARGIN ? available - SAFETY_MARGIN : 0;
+    if (depth > PAINT_DEPTH) {
+      depth = PAINT_DEPTH;
+    }
+    volatile uint8_t *bottom = reinterpret_cast<volatile uint8_t *>(top - depth);
+    for (size_t i = 0; i < depth; i++) {
+      bottom[i] = FILL;
+    }
+  }
+
+  size_t measure() const {
+    const volatile uint8_t *bottom =
+        reinterpret_cast<const volatile uint8_t *>(top - depth);
+    size_t untouched = 0;
+    while (untouched < depth && bottom[untouched] == FILL) {
+      untouched++;
+    }
+    return depth - untouched;
+  }
+};
+
+/**
+ * @brief Running timing statistics of profiled code paths.
+ *
+ * Times are counted in cycles of the DWT cycle counter on the device, which
+ * the firmware keeps running, and in nanoseconds of the monotonic clock on
+ * the host. Each probe keeps its count, min, max and total, plus a histogram
+ * with one bucket per power of two, from which p99 is read as the upper end
+ * of the bucket that holds it.
+ *
+ * Probes run on the app thread and in draw() on the GUI thread, so each
+ * thread records into a table of its own, claimed on its first sample, and
+ * is the only writer of it. A table bumps a sequence number around every
+ * update, and a reader copying a record retries if the number moved, as
+ * TemperatureFeed does. get() adds up the tables of a probe recorded by
+ * several threads. Tables are fixed: threads beyond MAX_THREADS and probes
+ * beyond MAX_PROBES are dropped.
+ */
+class PerfStats {
+public:
+  static constexpr size_t MAX_PROBES = 8;
+  static constexpr size_t MAX_THREADS = 2; // The app and GUI threads
+  static constexpr size_t BUCKETS = 32;
+
+  // A probe's statistics as read, over every thread that recorded it
+  struct Record {
+    const char *name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    // buckets[i] counts samples below 2^(i + 1), and at least 2^i for i > 0
+    uint32_t buckets[BUCKETS];
+
+    uint32_t average() const {
+      return count > 0 ? static_cast<uint32_t>(total / count) : 0;
+    }
+
+    uint32_t p99() const {
+      uint32_t samples = 0;
+      for (size_t i = 0; i < BUCKETS; i++) {
+        samples += buckets[i];
+      }
+      // Smallest bucket with at least 99% of the samples at or below it
+      uint32_t needed = samples - samples / 100;
+      uint32_t seen = 0;
+      for (size_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= needed && seen > 0) {
+          uint32_t upper =
+              i + 1 < BUCKETS ? (1u << (i + 1)) - 1 : UINT32_MAX;
+          return upper < max ? upper : max;
+        }
+      }
+      return max;
+    }
+  };
+
+  static uint32_t now() {
+#ifdef HOST
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<uint32_t>(time.tv_sec * 1000000000ull + time.tv_nsec);
+#else
+    return DWT->CYCCNT;
+#endif
+  }
+
+  // Units of now() per microsecond
+  static uint32_t ticks_per_us() {
+#ifdef HOST
+    return 1000;
+#else
+    return furi_hal_cortex_instructions_per_microsecond();
+#endif
+  }
+
+  static void record(const char *name, uint32_t elapsed) {
+    Table *table = current_table();
+    if (table == nullptr) {
+      return;
+    }
+    Slot *slot = table->find_or_add(name);
+    if (slot == nullptr) {
+      return;
+    }
+    table->begin_write();
+    if (slot->count.load(std::memory_order_relaxed) == 0 ||
+        elapsed < slot->min.load(std::memory_order_relaxed)) {
+      slot->min.store(elapsed, std::memory_order_relaxed);
+    }
+    if (elapsed > slot->max.load(std::memory_order_relaxed)) {
+      slot->max.store(elapsed, std::memory_order_relaxed);
+    }
+    slot->count.store(slot->count.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    uint32_t low = slot->total_low.load(std::memory_order_relaxed);
+    slot->total_low.store(low + elapsed, std::memory_order_relaxed);
+    if (low + elapsed < low) {
+      slot->total_high.store(
+          slot->total_high.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+    }
+
+    size_t bucket = elapsed > 1 ? 31 - __builtin_clz(elapsed) : 0;
+    if (slot->buckets[bucket].load(std::memory_order_relaxed) == UINT16_MAX) {
+      // Halving keeps the shape of the distribution, and with it p99
+      for (auto &count : slot->buckets) {
+        count.store(count.load(std::memory_order_relaxed) / 2,
+                    std::memory_order_relaxed);
+      }
+    }
+    slot->buckets[bucket].store(
+        slot->buckets[bucket].load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+    table->end_write();
+  }
+
+  // Probes recorded so far, by any thread
+  static size_t get_count() {
+    size_t probes = 0;
+    while (name_at(probes) != nullptr) {
+      probes++;
+    }
+    return probes;
+  }
+
+  /**
+   * @brief Statistics of probe i, in the order probes were first recorded,
+   * the app thread's first
+   * @return false if there is no probe i
+   */
+  static bool get(size_t i, Record &record) {
+    const char *name = name_at(i);
+    if (name == nullptr) {
+      return false;
+    }
+    record = Record{};
+    record.name = name;
+    for (const Table &table : tables) {
+      const Slot *slot = table.find(name);
+      if (slot != nullptr) {
+        table.add_to(*slot, record);
+      }
+    }
+    return true;
+  }
+
+  static uint32_t to_us(uint32_t ticks) { return ticks / ticks_per_us(); }
+
+  static void log_all() {
+    Record record;
+    for (size_t i = 0; get(i, record); i++) {
+      FURI_LOG_I(TAG_PERF_STATS,
+                 "%s: %lu calls, us min %lu avg %lu p99 %lu max %lu",
+                 record.name, static_cast<unsigned long>(record.count),
+                 static_cast<unsigned long>(to_us(record.min)),
+                 static_cast<unsigned long>(to_us(record.average())),
+                 static_cast<unsigned long>(to_us(record.p99())),
+                 static_cast<unsigned long>(to_us(record.max)));
+    }
+  }
+
+private:
+  struct Slot {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> min{0};
+    std::atomic<uint32_t> max{0};
+    std::atomic<uint32_t> total_low{0};
+    std::atomic<uint32_t> total_high{0};
+    std::atomic<uint16_t> buckets[BUCKETS]{};
+  };
+
+  class Table {
+  public:
+    std::atomic<FuriThreadId> owner{nullptr};
+
+    // Only called by the owner, the one thread that adds slots
+    Slot *find_or_add(const char *name) {
+      size_t used = count.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < used; i++) {
+        if (slots[i].name.load(std::memory_order_relaxed) == name) {
+          return &slots[i];
+        }
+      }
+      if (used == MAX_PROBES) {
+        return nullptr;
+      }
+      slots[used].name.store(name, std::memory_order_relaxed);
+      count.store(used + 1, std::memory_order_release);
+      return &slots[used];
+    }
+
+    const Slot *find(const char *name) const {
+      size_t used = count.load(std::memory_order_acquire);
+      for (size_t i = 0; i < used; i++) {
+        if (slots[i].name.load(std::memory_order_relaxed) == name) {
+          return &slots[i];
+        }
+      }
+      return nullptr;
+    }
+
+    const char *name_at(size_t i) const {
+      return i < count.load(std::memory_order_acquire)
+                 ? slots[i].name.load(std::memory_order_relaxed)
+                 : nullptr;
+    }
+
+    void begin_write() {
+      sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void end_write() {
+      sequence.store(sequence.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+    }
+
+    // Adds a consistent copy of slot to record, retrying while written
+    void add_to(const Slot &slot, Record &record) const {
+      uint32_t before;
+      uint32_t count_, min_, max_, low, high;
+      uint16_t buckets[BUCKETS];
+      do {
+        before = sequence.load(std::memory_order_acquire);
+        count_ = slot.count.load(std::memory_order_relaxed);
+        min_ = slot.min.load(std::memory_order_relaxed);
+        max_ = slot.max.load(std::memory_order_relaxed);
+        low = slot.total_low.load(std::memory_order_relaxed);
+        high = slot.total_high.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < BUCKETS; i++) {
+          buckets[i] = slot.buckets[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+      } while ((before & 1) ||
+               sequence.load(std::memory_order_relaxed) != before);
+
+      if (count_ == 0) {
+        return;
+      }
+      if (record.count == 0 || min_ < record.min) {
+        record.min = min_;
+      }
+      if (max_ > record.max) {
+        record.max = max_;
+      }
+      record.count += count_;
+      record.total += (static_cast<uint64_t>(high) << 32) | low;
+      for (size_t i = 0; i < BUCKETS; i++) {
+        record.buckets[i] += buckets[i];
+      }
+    }
+
+  private:
+    Slot slots[MAX_PROBES];
+    std::atomic<size_t> count{0};
+    // Odd while the owner updates a slot
+    std::atomic<uint32_t> sequence{0};
+  };
+
+  // The calling thread's table, claimed on first use
+  static Table *current_table() {
+    FuriThreadId self = furi_thread_get_current_id();
+    for (Table &table : tables) {
+      FuriThreadId owner = table.owner.load(std::memory_order_relaxed);
+      if (owner == nullptr &&
+          table.owner.compare_exchange_strong(owner, self)) {
+        return &table;
+      }
+      if (owner == self) {
+        return &table;
+      }
+    }
+    return nullptr;
+  }
+
+  // Name of probe i, counting each name once over the tables
+  static const char *name_at(size_t i) {
+    for (size_t t = 0; t < MAX_THREADS; t++) {
+      for (size_t j = 0; const char *name = tables[t].name_at(j); j++) {
+        bool seen = false;
+        for (size_t earlier = 0; earlier < t && !seen; earlier++) {
+          seen = tables[earlier].find(name) != nullptr;
+        }
+        if (!seen && i-- == 0) {
+          return name;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  static Table tables[MAX_THREADS];
+};
+
+inline PerfStats::Table PerfStats::tables[PerfStats::MAX_THREADS];
+
+/**
+ * @brief Times the enclosing scope into PerfStats
+ */
+class ProfileProbe {
+public:
+  explicit ProfileProbe(const char *name)
+      : name(name), start(PerfStats::now()) {}
+  ~ProfileProbe() { PerfStats::record(name, PerfStats::now() - start); }
+
+private:
+  const char *name;
+  uint32_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Profiles the rest of the enclosing scope under the given name
+#define PROFILE_SCOPE(name)                                                    \
+  ProfileProbe PROFILE_CONCAT(profile_probe_, __LINE__)(name)
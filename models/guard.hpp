@@ -1,69 +1,315 @@
 #pragma once
 
+#include "../instrumentation.hpp"
+#include <furi/core/event_flag.h>
 #include <furi/core/mutex.h>
+#include <atomic>
+#ifndef FILM_DEV_STATIC_STORAGE
 #include <memory>
+#endif
+
+/**
+ * @brief Contention counters of one lock, in kernel ticks
+ */
+struct LockStats {
+    uint32_t acquisitions; // write and read locks taken
+    uint32_t reads; // of which were shared
+    uint32_t contended; // had to wait for another thread
+    uint32_t timeouts; // try_lock()/try_read() calls that gave up
+    uint32_t total_wait_ticks;
+    uint32_t max_wait_ticks;
+    // Thread that held the lock during the longest wait, nullptr if the
+    // longest wait was only for readers to leave
+    FuriThreadId max_wait_owner;
+};
+
+/**
+ * @brief The lock behind Protected: one writer or any number of readers.
+ *
+ * A writer holds the mutex for as long as it has the lock. A reader holds it
+ * only while it registers, so readers don't block each other, and a writer
+ * that gets the mutex waits for the registered readers to leave. New readers
+ * queue at the mutex behind it, so a steady stream of readers cannot starve
+ * it. Taking the lock again from a thread that already holds it, to read
+ * or to write, would wait forever, so it stops the app instead. Readers
+ * are remembered in READER_SLOTS slots for this, a reader beyond them is
+ * not checked.
+ *
+ * The counters are updated with the mutex held. Readers like the debug view
+ * read them without it and can be one acquisition behind.
+ */
+class ProtectedLock {
+public:
+    ProtectedLock()
+        : mutex(furi_mutex_alloc(FuriMutexTypeNormal))
+        , readers_left(furi_event_flag_alloc()) {
+    }
+
+    ~ProtectedLock() {
+        if(mutex) {
+            furi_mutex_free(mutex);
+        }
+        if(readers_left) {
+            furi_event_flag_free(readers_left);
+        }
+    }
+
+    ProtectedLock(const ProtectedLock&) = delete;
+    ProtectedLock& operator=(const ProtectedLock&) = delete;
+
+    ProtectedLock(ProtectedLock&& other) noexcept
+        : mutex(other.mutex)
+        , readers_left(other.readers_left)
+        , stats(other.stats)
+        , timeouts(other.timeouts.load()) {
+        other.mutex = nullptr;
+        other.readers_left = nullptr;
+    }
+
+    ProtectedLock& operator=(ProtectedLock&& other) noexcept {
+        if(this != &other) {
+            if(mutex) {
+                furi_mutex_free(mutex);
+            }
+            if(readers_left) {
+                furi_event_flag_free(readers_left);
+            }
+            mutex = other.mutex;
+            readers_left = other.readers_left;
+            stats = other.stats;
+            timeouts = other.timeouts.load();
+            other.mutex = nullptr;
+            other.readers_left = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Take the lock
+     * @param timeout Ticks to wait at most, FuriWaitForever to wait until
+     * the lock is free
+     * @return false if the timeout ran out
+     */
+    bool acquire(bool shared, uint32_t timeout) {
+        PROFILE_SCOPE("Lock wait");
+        uint32_t start = furi_get_tick();
+        FuriThreadId owner = nullptr;
+        FuriThreadId self = furi_thread_get_current_id();
+        bool waited = false;
+
+        // A writer would wait for this thread's read to end
+        if(is_reading(self)) {
+            furi_crash("Protected locked twice by one thread");
+        }
+        if(furi_mutex_acquire(mutex, 0) != FuriStatusOk) {
+            owner = furi_mutex_get_owner(mutex);
+            if(owner == self) {
+                furi_crash("Protected locked twice by one thread");
+            }
+            waited = true;
+            if(furi_mutex_acquire(mutex, timeout) != FuriStatusOk) {
+                timeouts++;
+                return false;
+            }
+        }
+
+        if(!shared) {
+            while(readers.load() > 0) {
+                // A reader leaving between the clear and the check is seen by
+                // the check, one leaving after it sets the flag again
+                furi_event_flag_clear(readers_left, READERS_LEFT);
+                if(readers.load() == 0) {
+                    break;
+                }
+                waited = true;
+                uint32_t elapsed = furi_get_tick() - start;
+                uint32_t remaining = timeout == FuriWaitForever ? FuriWaitForever :
+                                     elapsed < timeout          ? timeout - elapsed :
+                                                                  0;
+                uint32_t flags = furi_event_flag_wait(
+                    readers_left, READERS_LEFT, FuriFlagWaitAny, remaining);
+                if((flags & FuriFlagError) && readers.load() > 0) {
+                    furi_mutex_release(mutex);
+                    timeouts++;
+                    return false;
+                }
+            }
+        }
+
+        stats.acquisitions++;
+        if(waited) {
+            uint32_t wait = furi_get_tick() - start;
+            stats.contended++;
+            stats.total_wait_ticks += wait;
+            if(wait >= stats.max_wait_ticks) {
+                stats.max_wait_ticks = wait;
+                stats.max_wait_owner = owner;
+            }
+        }
+        if(shared) {
+            stats.reads++;
+            readers++;
+            // Only registered with the mutex held, so no two readers take
+            // the same free slot
+            for(auto& slot : reader_threads) {
+                if(slot.load() == nullptr) {
+                    slot.store(self);
+                    break;
+                }
+            }
+            furi_mutex_release(mutex);
+        }
+        return true;
+    }
+
+    void release(bool shared) {
+        if(!shared) {
+            furi_mutex_release(mutex);
+            return;
+        }
+        FuriThreadId self = furi_thread_get_current_id();
+        for(auto& slot : reader_threads) {
+            if(slot.load() == self) {
+                slot.store(nullptr);
+                break;
+            }
+        }
+        if(--readers == 0) {
+            furi_event_flag_set(readers_left, READERS_LEFT);
+        }
+    }
+
+    LockStats get_stats() const {
+        LockStats copy = stats;
+        copy.timeouts = timeouts.load();
+        return copy;
+    }
+
+    // Thread holding the lock for writing, nullptr if none
+    FuriThreadId get_owner() const {
+        return furi_mutex_get_owner(mutex);
+    }
+
+private:
+    static constexpr uint32_t READERS_LEFT = 1;
+    // The app's readers are the GUI and dispatcher threads
+    static constexpr size_t READER_SLOTS = 4;
+
+    // Only a thread itself adds or removes its id, so it can check for it
+    // without the mutex
+    bool is_reading(FuriThreadId self) const {
+        for(const auto& slot : reader_threads) {
+            if(slot.load() == self) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    FuriMutex* mutex;
+    FuriEventFlag* readers_left;
+    std::atomic<uint32_t> readers{0};
+    std::atomic<FuriThreadId> reader_threads[READER_SLOTS]{};
+    LockStats stats{};
+    // Counted without the mutex, a timed out caller doesn't hold it
+    std::atomic<uint32_t> timeouts{0};
+};
 
 template<typename T>
 class Protected {
 private:
+#ifdef FILM_DEV_STATIC_STORAGE
+    // Held inline, so the model lives wherever its owner does
+    T value;
+    T* get() {
+        return &value;
+    }
+#else
     std::unique_ptr<T> model;
-    FuriMutex* mutex;
+    T* get() {
+        return model.get();
+    }
+#endif
+    ProtectedLock mutex;
 
 public:
-    class Guard {
+    /**
+     * @brief Holds the lock until destroyed. A guard from try_lock() or
+     * try_read() may be empty, test it before use.
+     * @tparam Access T for the write lock, const T for the shared one
+     */
+    template<typename Access, bool Shared>
+    class BasicGuard {
     private:
-        FuriMutex* mutex;
-        T* model;
-        
-        Guard(FuriMutex* mutex, T* model) : mutex(mutex), model(model) {
-            furi_mutex_acquire(mutex, FuriWaitForever);
+        ProtectedLock* mutex;
+        Access* model;
+
+        BasicGuard(ProtectedLock* mutex, Access* model, uint32_t timeout)
+            : mutex(mutex)
+            , model(mutex->acquire(Shared, timeout) ? model : nullptr) {
         }
-        
+
         friend class Protected;
-        
+
     public:
-        ~Guard() {
-            furi_mutex_release(mutex);
+        ~BasicGuard() {
+            if(model) {
+                mutex->release(Shared);
+            }
         }
-        
-        T* operator->() { return model; }
-        const T* operator->() const { return model; }
-        T& operator*() { return *model; }
-        const T& operator*() const { return *model; }
+
+        BasicGuard(const BasicGuard&) = delete;
+        BasicGuard& operator=(const BasicGuard&) = delete;
+
+        explicit operator bool() const { return model != nullptr; }
+        Access* operator->() const { return model; }
+        Access& operator*() const { return *model; }
     };
 
-    Protected() : model(std::make_unique<T>()), mutex(furi_mutex_alloc(FuriMutexTypeNormal)) {}
-    
-    ~Protected() {
-        if (mutex) {
-            furi_mutex_free(mutex);
-        }
-    }
+    using Guard = BasicGuard<T, false>;
+    using ReadGuard = BasicGuard<const T, true>;
+
+#ifdef FILM_DEV_STATIC_STORAGE
+    Protected() : value() {}
+#else
+    Protected() : model(std::make_unique<T>()) {}
+#endif
 
     // Get protected access to the model
     Guard lock() {
-        return Guard(mutex, model.get());
+        return Guard(&mutex, get(), FuriWaitForever);
+    }
+
+    // Like lock(), but gives up after timeout ticks
+    Guard try_lock(uint32_t timeout) {
+        return Guard(&mutex, get(), timeout);
+    }
+
+    // Read-only access, shared with other readers
+    ReadGuard read() {
+        return ReadGuard(&mutex, get(), FuriWaitForever);
+    }
+
+    // Like read(), but gives up after timeout ticks
+    ReadGuard try_read(uint32_t timeout) {
+        return ReadGuard(&mutex, get(), timeout);
+    }
+
+    const ProtectedLock& get_lock() const {
+        return mutex;
     }
 
     // Delete copy operations
     Protected(const Protected&) = delete;
     Protected& operator=(const Protected&) = delete;
 
+#ifdef FILM_DEV_STATIC_STORAGE
+    // An inline model cannot be handed over without copying it
+    Protected(Protected&&) = delete;
+    Protected& operator=(Protected&&) = delete;
+#else
     // Allow move operations
-    Protected(Protected&& other) noexcept 
-        : model(std::move(other.model)), mutex(other.mutex) {
-        other.mutex = nullptr;
-    }
-    
-    Protected& operator=(Protected&& other) noexcept {
-        if (this != &other) {
-            if (mutex) {
-                furi_mutex_free(mutex);
-            }
-            model = std::move(other.model);
-            mutex = other.mutex;
-            other.mutex = nullptr;
-        }
-        return *this;
-    }
-}; 
\ No newline at end of file
+    Protected(Protected&& other) noexcept = default;
+    Protected& operator=(Protected&& other) noexcept = default;
+#endif
+};
@@ -1,10 +1,13 @@
 #pragma once
 
-#include "../agitation/agitation_process_interpreter.hpp"
-#include "../agitation/agitation_processes.hpp"
+#include "../agitation/process_interpreter_interface.hpp"
+#include "../instrumentation.hpp"
 #include "../motor_controller.hpp"
+#include "../temperature_sensor.hpp"
 #include "guard.hpp"
+#include "time_format.hpp"
 #include <cstdint>
+#include <cstring>
 
 #define MODEL_TAG "FilmDevModel"
 
@@ -39,6 +42,72 @@ public:
     char status_text[64]{};
     char step_text[64]{};
     char movement_text[64]{};
+    // Copied when the process is selected, so drawing it needs neither the
+    // interpreter nor the process library, which only the dispatcher thread
+    // touches
+    char process_name[32]{};
+
+    static constexpr int16_t NO_TEMPERATURE = INT16_MIN;
+
+    // Bits of DisplaySnapshot::dirty_since, one per part of the screen
+    enum DirtyField : uint8_t {
+        DirtyStep = 1 << 0,
+        DirtyTime = 1 << 1,
+        DirtyMovement = 1 << 2,
+        DirtyMotor = 1 << 3,
+        DirtyHint = 1 << 4,
+        DirtyProcess = 1 << 5,
+        DirtyTemperature = 1 << 6,
+        DirtyAll = 0x7F,
+    };
+
+    /**
+     * @brief What a view showed the last time it drew.
+     *
+     * The texts are compared through revision counters, bumped only when a
+     * text actually changes, so a view can tell in a few compares whether a
+     * tick changed anything it displays.
+     */
+    struct DisplaySnapshot {
+        uint16_t step_revision{0};
+        uint16_t status_revision{0};
+        uint16_t movement_revision{0};
+        MotorController::Direction motor{MotorController::Direction::Stopped};
+        ProcessState process_state{ProcessState::NotStarted};
+        size_t process_index{SIZE_MAX};
+        // Probe reading in tenths of a degree, NO_TEMPERATURE without one
+        int16_t temperature_tenths{NO_TEMPERATURE};
+        bool valid{false};
+
+        uint8_t dirty_since(const DisplaySnapshot& drawn) const {
+            if(!drawn.valid) {
+                return DirtyAll;
+            }
+            uint8_t dirty = 0;
+            if(step_revision != drawn.step_revision) {
+                dirty |= DirtyStep;
+            }
+            if(status_revision != drawn.status_revision) {
+                dirty |= DirtyTime;
+            }
+            if(movement_revision != drawn.movement_revision) {
+                dirty |= DirtyMovement;
+            }
+            if(motor != drawn.motor) {
+                dirty |= DirtyMotor;
+            }
+            if(process_state != drawn.process_state) {
+                dirty |= DirtyHint;
+            }
+            if(process_index != drawn.process_index) {
+                dirty |= DirtyProcess;
+            }
+            if(temperature_tenths != drawn.temperature_tenths) {
+                dirty |= DirtyTemperature;
+            }
+            return dirty;
+        }
+    };
 
     // Process settings
     int8_t push_pull_stops{0};
@@ -51,17 +120,24 @@ public:
 
     ProcessInterpreterInterface* process_interpreter{nullptr};
     MotorController* motor_controller{nullptr};
+    // Probe readings, nullptr without a sampler
+    const TemperatureFeed* temperature_feed{nullptr};
 
     void init() {
         reset();
     }
 
-    void set_process(const char* process_name) {
-        if(process_interpreter) {
-            process_interpreter->selectProcess(process_name);
-            process_interpreter->setProcessPushPull(push_pull_stops);
-            process_interpreter->setRolls(roll_count);
+    // Index in the interpreter's process list. False if it could not be
+    // loaded, the interpreter then keeps a built-in process.
+    bool set_process(size_t index) {
+        if(!process_interpreter) {
+            return false;
         }
+        bool loaded = process_interpreter->selectProcess(index);
+        process_interpreter->setProcessPushPull(push_pull_stops);
+        process_interpreter->setRolls(roll_count);
+        copy_process_name();
+        return loaded;
     }
 
     // Process state transitions
@@ -194,7 +270,47 @@ public:
         return process_state == ProcessState::WaitingForUser;
     }
 
+    DisplaySnapshot display_snapshot() const {
+        DisplaySnapshot snapshot;
+        snapshot.step_revision = step_revision;
+        snapshot.status_revision = status_revision;
+        snapshot.movement_revision = movement_revision;
+        if(motor_controller) {
+            snapshot.motor = motor_controller->getDirection();
+        }
+        snapshot.process_state = process_state;
+        if(process_interpreter) {
+            snapshot.process_index = process_interpreter->getCurrentProcessIndex();
+        }
+        if(temperature_feed) {
+            TemperatureReading reading = temperature_feed->read();
+            if(reading.valid) {
+                snapshot.temperature_tenths = static_cast<int16_t>(
+                    reading.celsius * 10.0f + (reading.celsius < 0 ? -0.5f : 0.5f));
+            }
+        }
+        snapshot.valid = true;
+        return snapshot;
+    }
+
+    // Rewrites only the elapsed digits when the state prefix, the total
+    // duration and the clock width are unchanged since the last call.
     void update_status(uint32_t elapsed, uint32_t duration) {
+        uint32_t elapsed_s = elapsed / 1000;
+        uint32_t duration_s = duration / 1000;
+        size_t elapsed_width = time_format::width(elapsed_s);
+
+        if(status_layout.valid && status_layout.state == process_state &&
+           status_layout.duration_s == duration_s &&
+           status_layout.elapsed_width == elapsed_width) {
+            if(status_layout.elapsed_s != elapsed_s) {
+                time_format::write_clock(status_text + status_layout.elapsed_offset, elapsed_s);
+                status_layout.elapsed_s = elapsed_s;
+                status_revision++;
+            }
+            return;
+        }
+
         const char* state_prefix = "";
         switch(process_state) {
         case ProcessState::Paused:
@@ -207,27 +323,54 @@ public:
             break;
         }
 
-        snprintf(
-            status_text,
-            sizeof(status_text),
-            "%sTime: %02lu:%02lu/%02lu:%02lu",
-            state_prefix,
-            (unsigned long)((elapsed / 1000) / 60), // Minutes
-            (unsigned long)((elapsed / 1000) % 60), // Seconds
-            (unsigned long)((duration / 1000) / 60), // Total Minutes
-            (unsigned long)((duration / 1000) % 60) // Total Seconds
-        );
+        // The longest line, "[WAITING] Time: hh:mm:ss/hh:mm:ss", fits easily
+        char* out = status_text;
+        out += time_format::write_str(out, sizeof(status_text), state_prefix);
+        out += time_format::write_str(out, sizeof(status_text) - (out - status_text), "Time: ");
+        status_layout.elapsed_offset = static_cast<uint8_t>(out - status_text);
+        out += time_format::write_clock(out, elapsed_s);
+        *out++ = '/';
+        out += time_format::write_clock(out, duration_s);
+        *out = '\0';
+
+        status_layout.state = process_state;
+        status_layout.duration_s = duration_s;
+        status_layout.elapsed_s = elapsed_s;
+        status_layout.elapsed_width = static_cast<uint8_t>(elapsed_width);
+        status_layout.valid = true;
+        status_revision++;
     }
 
+    // The step and direction names are static strings, so an unchanged
+    // pointer means an unchanged text.
     void update_step_text(const char* step_name) {
-        snprintf(step_text, sizeof(step_text), "Step: %s", step_name);
+        if(step_name == step_source) {
+            return;
+        }
+        step_source = step_name;
+        compose(step_text, "Step: ", step_name, step_revision);
     }
 
     void update_movement_text(const char* direction) {
-        snprintf(movement_text, sizeof(movement_text), "Movement: %s", direction);
+        if(direction == movement_source) {
+            return;
+        }
+        movement_source = direction;
+        compose(movement_text, "Movement: ", direction, movement_revision);
+    }
+
+    // Refreshes only the time line; the step and movement texts are rebuilt
+    // by update() when the interpreter reports a change.
+    void update_time() {
+        if(process_interpreter) {
+            update_status(
+                process_interpreter->getCurrentMovementTimeElapsed(),
+                process_interpreter->getCurrentMovementDuration());
+        }
     }
 
     void update() {
+        PROFILE_SCOPE("Model update");
         if(process_interpreter) {
             update_step_text(process_interpreter->getCurrentStepName());
             update_status(
@@ -244,6 +387,7 @@ public:
             process_interpreter->init();
             process_interpreter->setProcessPushPull(push_pull_stops);
             process_interpreter->setRolls(roll_count);
+            copy_process_name();
         }
 
         reset_process_state();
@@ -251,15 +395,26 @@ public:
         FURI_LOG_I(MODEL_TAG, "Model reset");
     }
 
+    // The current one, which is not the selected one if that failed to load
+    void copy_process_name() {
+        if(!process_interpreter->getProcessName(
+               process_interpreter->getCurrentProcessIndex(), process_name, sizeof(process_name))) {
+            process_name[0] = '\0';
+        }
+    }
+
     void reset_process_state() {
         FURI_LOG_I(MODEL_TAG, "Resetting process state");
         process_state = ProcessState::NotStarted;
         process_interpreter->stop();
         process_interpreter->reset();
 
-        snprintf(status_text, sizeof(status_text), "Press OK to start");
-        snprintf(step_text, sizeof(step_text), "Ready");
-        snprintf(movement_text, sizeof(movement_text), "Movement: Idle");
+        status_layout.valid = false;
+        step_source = nullptr;
+        movement_source = nullptr;
+        publish(status_text, "Press OK to start", status_revision);
+        publish(step_text, "Ready", step_revision);
+        publish(movement_text, "Movement: Idle", movement_revision);
     }
 
     // Process settings methods
@@ -271,6 +426,45 @@ public:
     const char* get_push_pull_text() const {
         return PUSH_PULL_VALUES[push_pull_stops + 2];
     }
+
+private:
+    uint16_t step_revision{0};
+    uint16_t status_revision{0};
+    uint16_t movement_revision{0};
+
+    // Where the elapsed clock sits in status_text, and what it was built from
+    struct StatusLayout {
+        ProcessState state{ProcessState::NotStarted};
+        uint32_t duration_s{0};
+        uint32_t elapsed_s{0};
+        uint8_t elapsed_offset{0};
+        uint8_t elapsed_width{0};
+        bool valid{false};
+    } status_layout;
+
+    // Source strings of step_text and movement_text
+    const char* step_source{nullptr};
+    const char* movement_source{nullptr};
+
+    template <size_t N>
+    static void
+        compose(char (&field)[N], const char* label, const char* value, uint16_t& revision) {
+        size_t length = time_format::write_str(field, N - 1, label);
+        length += time_format::write_str(field + length, N - 1 - length, value);
+        field[length] = '\0';
+        revision++;
+    }
+
+    // Stores text in field, bumping the revision only if it changed
+    template <size_t N>
+    static void publish(char (&field)[N], const char* text, uint16_t& revision) {
+        if(strncmp(field, text, N) == 0) {
+            return;
+        }
+        strncpy(field, text, N - 1);
+        field[N - 1] = '\0';
+        revision++;
+    }
 };
 
 // Type alias for protected main view model
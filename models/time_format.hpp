@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Integer-only clock formatting for the status line.
+ *
+ * Durations below an hour are written as mm:ss, longer ones as hh:mm:ss
+ * (clamped to 99:59:59). Nothing is NUL terminated, so the digits can be
+ * rewritten in place inside an already laid out string.
+ */
+namespace time_format {
+
+constexpr size_t SHORT_WIDTH = 5; // mm:ss
+constexpr size_t LONG_WIDTH = 8; // hh:mm:ss
+constexpr uint32_t MAX_SECONDS = 99 * 3600 + 59 * 60 + 59;
+
+inline size_t width(uint32_t seconds) {
+    return seconds < 3600 ? SHORT_WIDTH : LONG_WIDTH;
+}
+
+inline void write_two_digits(char* out, uint32_t value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+}
+
+// Writes width(seconds) characters to out and returns that width
+inline size_t write_clock(char* out, uint32_t seconds) {
+    if(seconds > MAX_SECONDS) {
+        seconds = MAX_SECONDS;
+    }
+    size_t pos = 0;
+    if(seconds >= 3600) {
+        write_two_digits(out, seconds / 3600);
+        out[2] = ':';
+        pos = 3;
+        seconds %= 3600;
+    }
+    write_two_digits(out + pos, seconds / 60);
+    out[pos + 2] = ':';
+    write_two_digits(out + pos + 3, seconds % 60);
+    return pos + SHORT_WIDTH;
+}
+
+// Copies a NUL terminated string without the terminator, bounded by capacity
+inline size_t write_str(char* out, size_t capacity, const char* text) {
+    size_t length = 0;
+    while(length < capacity && text[length] != '\0') {
+        out[length] = text[length];
+        length++;
+    }
+    return length;
+}
+
+} // namespace time_format
@@ -2,6 +2,8 @@
 
 class MotorController {
 public:
+  enum class Direction { Stopped, Clockwise, CounterClockwise };
+
   virtual void clockwise(bool enable) = 0;
   virtual void counterClockwise(bool enable) = 0;
   virtual void stop() = 0;
@@ -13,6 +15,17 @@ public:
 
   virtual ~MotorController() = default;
 
+  // Snapshot of the current drive state
+  Direction getDirection() const {
+    if (isClockwise()) {
+      return Direction::Clockwise;
+    }
+    if (isCounterClockwise()) {
+      return Direction::CounterClockwise;
+    }
+    return Direction::Stopped;
+  }
+
   // Prevent copying for all derived classes
   MotorController(const MotorController &) = delete;
   MotorController &operator=(const MotorController &) = delete;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <furi.h>
+#include <new>
+#include <stddef.h>
+#include <utility>
+
+/**
+ * @brief Statically sized storage for a single object.
+ *
+ * With FILM_DEV_STATIC_STORAGE, the app builds its long-lived objects in
+ * slots like this one instead of on the heap. That keeps a long session from
+ * fragmenting the heap. The slot reserves Budget bytes, and a type that
+ * outgrows its budget fails to compile, so size regressions show up in the
+ * build rather than on the device.
+ */
+template <typename T, size_t Budget = sizeof(T)> class StaticSlot {
+  static_assert(sizeof(T) <= Budget, "Object exceeds its static storage budget");
+
+public:
+  StaticSlot() = default;
+  StaticSlot(const StaticSlot &) = delete;
+  StaticSlot &operator=(const StaticSlot &) = delete;
+
+  template <typename... Args> T *construct(Args &&...args) {
+    furi_check(!constructed);
+    T *object = new (storage) T(std::forward<Args>(args)...);
+    constructed = true;
+    return object;
+  }
+
+  void destroy() {
+    if (constructed) {
+      get()->~T();
+      constructed = false;
+    }
+  }
+
+  T *get() { return std::launder(reinterpret_cast<T *>(storage)); }
+  bool is_constructed() const { return constructed; }
+
+private:
+  alignas(T) unsigned char storage[Budget];
+  bool constructed{false};
+};
+
+#ifdef FILM_DEV_STATIC_STORAGE
+// Any heap allocation left in app code becomes a build error. Placement new,
+// as used by StaticSlot, is a different overload and
+// stays available.
+void *operator new(size_t size)
+    __attribute__((error("heap allocation in FILM_DEV_STATIC_STORAGE mode")));
+void *operator new[](size_t size)
+    __attribute__((error("heap allocation in FILM_DEV_STATIC_STORAGE mode")));
+#endif
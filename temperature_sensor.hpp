@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <furi.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define TEMPERATURE_TAG "Temperature"
+
+/**
+ * @brief Temperature probe sampling.
+ *
+ * A TemperatureSampler reads a TemperatureSource on its own thread, filters
+ * the readings and publishes the latest one through a TemperatureFeed. Bus
+ * transactions take hundreds of milliseconds on a 1-Wire probe, so nothing
+ * else waits for them: the interpreter and the views read the feed, which
+ * never blocks.
+ */
+
+/**
+ * @brief A filtered probe reading
+ */
+struct TemperatureReading {
+  float celsius;
+  uint32_t taken_at; // Kernel tick of the sample
+  uint32_t samples;  // Good samples since the sampler started
+  bool valid;        // false until the first sample, or while the probe fails
+};
+
+/**
+ * @brief A probe. sample() may block for the whole bus transaction, it is
+ * only called from the sampler thread.
+ */
+class TemperatureSource {
+public:
+  virtual ~TemperatureSource() = default;
+
+  virtual bool begin() { return true; }
+  virtual void end() {}
+  // false if the probe did not answer or the data was corrupt
+  virtual bool sample(float &celsius) = 0;
+  virtual const char *getName() const = 0;
+  // Sampling faster than this only repeats readings
+  virtual uint32_t getMinPeriodMs() const { return 0; }
+};
+
+/**
+ * @brief The latest reading, written by one thread and read by any.
+ *
+ * Two slots and a sequence number: the writer fills the slot readers are
+ * not using and then bumps the sequence, which makes the slot current.
+ * A reader copies the current slot and checks that the sequence did not
+ * move meanwhile, retrying if it did. The published slot is always
+ * complete, so a reader that preempts the writer never waits for it, unlike
+ * with a lock or a plain seqlock.
+ */
+class TemperatureFeed {
+public:
+  void publish(const TemperatureReading &reading) {
+    uint32_t next = sequence.load(std::memory_order_relaxed) + 1;
+    Slot &slot = slots[next & 1];
+    // The slot was current two publishes ago. A reader still copying it
+    // must see the last sequence bump once it sees any of these stores.
+    std::atomic_thread_fence(std::memory_order_release);
+    uint32_t bits;
+    memcpy(&bits, &reading.celsius, sizeof(bits));
+    slot.celsius.store(bits, std::memory_order_relaxed);
+    slot.taken_at.store(reading.taken_at, std::memory_order_relaxed);
+    slot.samples.store(reading.samples, std::memory_order_relaxed);
+    slot.valid.store(reading.valid, std::memory_order_relaxed);
+    sequence.store(next, std::memory_order_release);
+  }
+
+  TemperatureReading read() const {
+    TemperatureReading reading;
+    uint32_t current;
+    do {
+      current = sequence.load(std::memory_order_acquire);
+      const Slot &slot = slots[current & 1];
+      uint32_t bits = slot.celsius.load(std::memory_order_relaxed);
+      memcpy(&reading.celsius, &bits, sizeof(bits));
+      reading.taken_at = slot.taken_at.load(std::memory_order_relaxed);
+      reading.samples = slot.samples.load(std::memory_order_relaxed);
+      reading.valid = slot.valid.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+    } while (sequence.load(std::memory_order_relaxed) != current);
+    return reading;
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint32_t> celsius{0};
+    std::atomic<uint32_t> taken_at{0};
+    std::atomic<uint32_t> samples{0};
+    std::atomic<bool> valid{false};
+  };
+
+  Slot slots[2];
+  std::atomic<uint32_t> sequence{0};
+};
+
+/**
+ * @brief Mean of the last Size samples
+ */
+template <size_t Size> class MovingAverageFilter {
+public:
+  float update(float value) {
+    if (count < Size) {
+      count++;
+    } else {
+      sum -= window[next];
+    }
+    window[next] = value;
+    sum += value;
+    next = (next + 1) % Size;
+    return sum / count;
+  }
+
+  void reset() {
+    sum = 0;
+    count = 0;
+    next = 0;
+  }
+
+private:
+  float window[Size]{};
+  float sum{0};
+  size_t count{0};
+  size_t next{0};
+};
+
+/**
+ * @brief One-dimensional Kalman filter for a slowly drifting value.
+ *
+ * Follows a water bath closely with less lag than a moving average of the
+ * same smoothness, and settles in a few samples after a reset.
+ */
+class KalmanFilter {
+public:
+  // Variances in degrees squared: how much the bath drifts between samples,
+  // and how noisy the probe is
+  explicit KalmanFilter(float process_noise = 0.001f,
+                        float measurement_noise = 0.01f)
+      : process_noise(process_noise), measurement_noise(measurement_noise) {}
+
+  float update(float value) {
+    if (!primed) {
+      estimate = value;
+      error = measurement_noise;
+      primed = true;
+      return estimate;
+    }
+    error += process_noise;
+    float gain = error / (error + measurement_noise);
+    estimate += gain * (value - estimate);
+    error *= 1.0f - gain;
+    return estimate;
+  }
+
+  void reset() { primed = false; }
+
+private:
+  float process_noise;
+  float measurement_noise;
+  float estimate{0};
+  float error{0};
+  bool primed{false};
+};
+
+/**
+ * @brief Samples a TemperatureSource on a thread of its own. Until begin()
+ * succeeds, and again after MAX_FAILURES failed samples, the thread calls
+ * begin() every period, so a probe plugged in late is still read.
+ * @tparam Filter Provides float update(float) and reset()
+ */
+template <typename Filter = KalmanFilter> class TemperatureSampler {
+public:
+  static constexpr uint32_t DEFAULT_PERIOD_MS = 1000;
+  // Failed samples in a row before the reading is marked invalid
+  static constexpr uint32_t MAX_FAILURES = 3;
+
+  explicit TemperatureSampler(TemperatureSource &source,
+                              Filter filter = Filter())
+      : source(source), filter(filter) {}
+
+  ~TemperatureSampler() { stop(); }
+
+  TemperatureSampler(const TemperatureSampler &) = delete;
+  TemperatureSampler &operator=(const TemperatureSampler &) = delete;
+
+  // Starts the thread even without a probe, the thread keeps looking for
+  // one, so a probe plugged in later is picked up
+  void start() {
+    if (thread) {
+      return;
+    }
+    thread = furi_thread_alloc_ex("TempSampler", STACK_SIZE, run, this);
+    furi_thread_set_priority(thread, FuriThreadPriorityLow);
+    furi_thread_start(thread);
+    FURI_LOG_I(TEMPERATURE_TAG, "Sampling %s every %lu ms", source.getName(),
+               (unsigned long)getPeriodMs());
+  }
+
+  void stop() {
+    if (!thread) {
+      return;
+    }
+    furi_thread_flags_set(furi_thread_get_id(thread), FLAG_STOP);
+    furi_thread_join(thread);
+    furi_thread_free(thread);
+    thread = nullptr;
+    if (begun) {
+      source.end();
+      begun = false;
+    }
+  }
+
+  // Takes effect after the sample in progress
+  void setPeriodMs(uint32_t period_ms) { this->period_ms = period_ms; }
+
+  uint32_t getPeriodMs() const {
+    uint32_t minimum = source.getMinPeriodMs();
+    uint32_t period = period_ms.load();
+    return period < minimum ? minimum : period;
+  }
+
+  const TemperatureFeed &getFeed() const { return feed; }
+
+private:
+  static constexpr uint32_t STACK_SIZE = 1024;
+  static constexpr uint32_t FLAG_STOP = 1;
+
+  static int32_t run(void *context) {
+    static_cast<TemperatureSampler *>(context)->loop();
+    return 0;
+  }
+
+  void loop() {
+    TemperatureReading reading{0, 0, 0, false};
+    uint32_t failures = 0;
+    bool reported_missing = false;
+    while (true) {
+      uint32_t started = furi_get_tick();
+      if (!begun) {
+        begun = source.begin();
+        if (begun && reported_missing) {
+          FURI_LOG_I(TEMPERATURE_TAG, "%s probe found", source.getName());
+        } else if (!begun && !reported_missing) {
+          FURI_LOG_W(TEMPERATURE_TAG, "No %s probe, still looking",
+                     source.getName());
+        }
+        reported_missing = !begun;
+      }
+      float celsius;
+      if (!begun) {
+        // Looked for again next period
+      } else if (source.sample(celsius)) {
+        if (!reading.valid) {
+          // Don't blend in readings from before the probe dropped out
+          filter.reset();
+        }
+        reading.celsius = filter.update(celsius);
+        reading.taken_at = furi_get_tick();
+        reading.samples++;
+        reading.valid = true;
+        failures = 0;
+        feed.publish(reading);
+      } else if (++failures == MAX_FAILURES) {
+        if (reading.valid) {
+          FURI_LOG_W(TEMPERATURE_TAG, "%s probe stopped answering",
+                     source.getName());
+          reading.valid = false;
+          feed.publish(reading);
+        }
+        // Set the probe up again, it may have been unplugged and replaced
+        source.end();
+        begun = false;
+        failures = 0;
+      }
+
+      // Sleep the rest of the period, or until stop() is called
+      uint32_t spent = furi_get_tick() - started;
+      uint32_t period = furi_ms_to_ticks(getPeriodMs());
+      uint32_t flags = furi_thread_flags_wait(
+          FLAG_STOP, FuriFlagWaitAny, spent < period ? period - spent : 0);
+      if (!(flags & FuriFlagError) && (flags & FLAG_STOP)) {
+        break;
+      }
+    }
+  }
+
+  TemperatureSource &source;
+  Filter filter;
+  TemperatureFeed feed;
+  FuriThread *thread{nullptr};
+  // Whether source.begin() succeeded, only used by the thread while it runs
+  bool begun{false};
+  std::atomic<uint32_t> period_ms{DEFAULT_PERIOD_MS};
+};
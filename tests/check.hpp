@@ -0,0 +1,49 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+
+/**
+ * @brief Assertions for the host tests. A failed check prints where and
+ * why, the test goes on so one run shows every failure, and
+ * check_result() turns them into the exit code ctest looks at.
+ */
+
+inline int& check_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                             \
+    do {                                                                             \
+        if(!(condition)) {                                                           \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            check_failures()++;                                                      \
+        }                                                                            \
+    } while(0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                            \
+    do {                                                                   \
+        double check_actual = (actual);                                    \
+        double check_expected = (expected);                                \
+        if(!(fabs(check_actual - check_expected) <= (tolerance))) {        \
+            fprintf(                                                       \
+                stderr,                                                    \
+                "%s:%d: %s is %g, expected %g within %g\n",                \
+                __FILE__,                                                  \
+                __LINE__,                                                  \
+                #actual,                                                   \
+                check_actual,                                              \
+                check_expected,                                            \
+                static_cast<double>(tolerance));                           \
+            check_failures()++;                                            \
+        }                                                                  \
+    } while(0)
+
+inline int check_result() {
+    if(check_failures() > 0) {
+        fprintf(stderr, "%d checks failed\n", check_failures());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "check.hpp"
+#include "agitation/interpreter.hpp"
+
+/**
+ * Runs the CineStill developer step on VirtualClock, ticking every
+ * millisecond as a worst case for the progress sum, with the bath read
+ * from a TemperatureFeed as the sampler would publish it.
+ */
+
+namespace {
+
+using HostInterpreter = Interpreter<VirtualClock, RecordingMotor>;
+
+constexpr uint32_t SECOND_MS = 1000;
+constexpr uint32_t MINUTE_MS = 60 * SECOND_MS;
+// Ticks land on milliseconds, the end is rounded to the nearest
+constexpr double END_TOLERANCE_MS = 2;
+
+float celsius(float fahrenheit) {
+    return (fahrenheit - 32.0f) / 1.8f;
+}
+
+struct Rig {
+    RecordingMotor motor;
+    HostInterpreter interpreter{motor};
+    TemperatureFeed feed;
+    uint32_t samples = 0;
+
+    Rig() {
+        // CineStill C41, set to 102 F, developer first
+        interpreter.selectProcess(size_t(0));
+    }
+
+    void bath(float fahrenheit) {
+        feed.publish({celsius(fahrenheit), interpreter.getClock().now_ms(), ++samples, true});
+    }
+
+    // Ticks until the step waits for the user, up to limit_ms, and returns
+    // how long that took
+    uint32_t run_step(uint32_t limit_ms, uint32_t change_at_ms = 0, float change_to = 0) {
+        uint32_t started = interpreter.getClock().now_ms();
+        uint32_t ran = 0;
+        while(interpreter.getState() == ProcessState::Running && ran < limit_ms) {
+            interpreter.getClock().advance(1);
+            ran++;
+            if(change_at_ms > 0 && ran == change_at_ms) {
+                bath(change_to);
+            }
+            interpreter.tick();
+        }
+        return interpreter.getClock().now_ms() - started;
+    }
+};
+
+void lasts_the_tabulated_time_without_a_probe() {
+    Rig rig;
+    CHECK(rig.interpreter.getCurrentMovementDuration() == 3.5 * MINUTE_MS);
+    rig.interpreter.start();
+    uint32_t ran = rig.run_step(10 * MINUTE_MS);
+    CHECK(rig.interpreter.isWaitingForUser());
+    CHECK_NEAR(ran, 3.5 * MINUTE_MS, END_TOLERANCE_MS);
+}
+
+void follows_a_steady_cool_bath() {
+    Rig rig;
+    rig.interpreter.setTemperatureFeed(&rig.feed);
+    rig.bath(95);
+    rig.interpreter.start();
+    // Projected from the bath as soon as the step starts
+    CHECK_NEAR(rig.interpreter.getCurrentMovementDuration(), 5.75 * MINUTE_MS, END_TOLERANCE_MS);
+    uint32_t ran = rig.run_step(10 * MINUTE_MS);
+    CHECK(rig.interpreter.isWaitingForUser());
+    // 345 000 increments of about 3e-6 add up to one development
+    CHECK_NEAR(ran, 5.75 * MINUTE_MS, END_TOLERANCE_MS);
+}
+
+void moves_the_end_when_the_bath_warms() {
+    Rig rig;
+    rig.interpreter.setTemperatureFeed(&rig.feed);
+    rig.bath(95);
+    rig.interpreter.start();
+    // 100 s at 95 F develop 100 / 345 of the film, the rest at 102 F
+    uint32_t ran = rig.run_step(10 * MINUTE_MS, 100 * SECOND_MS, 102);
+    CHECK(rig.interpreter.isWaitingForUser());
+    double expected = 100 * SECOND_MS + (1 - 100.0 / 345.0) * 3.5 * MINUTE_MS;
+    CHECK_NEAR(ran, expected, END_TOLERANCE_MS);
+}
+
+void develops_at_the_set_rate_without_a_reading() {
+    Rig rig;
+    rig.interpreter.setTemperatureFeed(&rig.feed);
+    rig.interpreter.start();
+    uint32_t ran = rig.run_step(10 * MINUTE_MS);
+    CHECK_NEAR(ran, 3.5 * MINUTE_MS, END_TOLERANCE_MS);
+
+    // A bath off the table develops at the set temperature's rate
+    Rig hot;
+    hot.interpreter.setTemperatureFeed(&hot.feed);
+    hot.bath(110);
+    hot.interpreter.start();
+    ran = hot.run_step(10 * MINUTE_MS);
+    CHECK_NEAR(ran, 3.5 * MINUTE_MS, END_TOLERANCE_MS);
+}
+
+} // namespace
+
+int main() {
+    lasts_the_tabulated_time_without_a_probe();
+    follows_a_steady_cool_bath();
+    moves_the_end_when_the_bath_warms();
+    develops_at_the_set_rate_without_a_reading();
+    return check_result();
+}
@@ -0,0 +1,196 @@
+#include "check.hpp"
+#include "agitation/dev_time_loader.hpp"
+#include "agitation/dev_time_table.hpp"
+
+/**
+ * Looks times up in tables laid out like the ones in processes/ and checks
+ * the curve along temperature passes through the grid, keeps the direction
+ * of its neighbours and never leaves the range of the cell it is in.
+ */
+
+namespace {
+
+// The CineStill Cs41 grid, Fahrenheit against push/pull
+constexpr float TEMPERATURES[] = {75.0, 80.0, 85.0, 90.0, 95.0, 102.0};
+constexpr float PUSH_PULL[] = {-1, 0, 1, 2, 3};
+constexpr float MINUTES[] = {
+    27.0, 16.25, 10.0, 6.5, 4.5, 2.75, // Pull 1
+    35.0, 21.0, 13.0, 8.5, 5.75, 3.5, // Normal
+    50.0, 28.0, 17.0, 11.0, 7.5, 4.55, // Push 1
+    -1.0, 37.0, 25.0, 14.75, 10.0, 6.13, // Push 2
+    -1.0, -1.0, 35.0, 21.0, 14.33, 8.75, // Push 3
+};
+DEV_TIME_SLOPES(SLOPES, TEMPERATURES, MINUTES);
+
+constexpr DevTimeTable TABLE = {
+    .axes =
+        {{DevTimeAxisKind::Temperature, TEMPERATURES, COUNT_OF(TEMPERATURES)},
+         {DevTimeAxisKind::PushPull, PUSH_PULL, COUNT_OF(PUSH_PULL)}},
+    .axis_count = 2,
+    .minutes = MINUTES,
+    .slopes = SLOPES.data(),
+    .exhaustion_per_roll = 0.02f,
+    .fahrenheit = true};
+static_assert(dev_time_table::is_valid(TABLE), "Test table is malformed");
+
+// A plateau then a drop, where a plain cubic rings above the plateau
+constexpr float STEP_POINTS[] = {0, 1, 2, 3, 4, 5};
+constexpr float STEP_MINUTES[] = {10, 10, 10, 2, 1, 1};
+DEV_TIME_SLOPES(STEP_SLOPES, STEP_POINTS, STEP_MINUTES);
+
+constexpr DevTimeTable STEP_TABLE = {
+    .axes = {{DevTimeAxisKind::Temperature, STEP_POINTS, COUNT_OF(STEP_POINTS)}},
+    .axis_count = 1,
+    .minutes = STEP_MINUTES,
+    .slopes = STEP_SLOPES.data(),
+    .exhaustion_per_roll = 0,
+    .fahrenheit = false};
+
+float minutes_at(const DevTimeTable& table, float temperature, float push_pull = 0) {
+    return dev_time_minutes(table, {temperature, push_pull, 0, 1});
+}
+
+void passes_through_the_grid() {
+    for(size_t row = 0; row < COUNT_OF(PUSH_PULL); row++) {
+        for(size_t i = 0; i < COUNT_OF(TEMPERATURES); i++) {
+            float expected = MINUTES[i + row * COUNT_OF(TEMPERATURES)];
+            if(expected >= 0) {
+                CHECK_NEAR(minutes_at(TABLE, TEMPERATURES[i], PUSH_PULL[row]), expected, 1e-4);
+            }
+        }
+    }
+}
+
+// Sweeps every interval of a row: each step shortens the time, and the time
+// stays between the two grid points around it
+void stays_monotone_within_cells(const DevTimeTable& table, float push_pull) {
+    const DevTimeAxis& axis = table.axes[0];
+    size_t row = 0;
+    while(row + 1 < table.axes[1].count && table.axes[1].points[row] != push_pull) {
+        row++;
+    }
+    const float* minutes = table.minutes + row * axis.count;
+    for(size_t i = 0; i + 1 < axis.count; i++) {
+        if(minutes[i] < 0 || minutes[i + 1] < 0) {
+            continue;
+        }
+        float previous = minutes[i];
+        for(int step = 1; step <= 100; step++) {
+            float x = axis.points[i] + (axis.points[i + 1] - axis.points[i]) * step / 100.0f;
+            float y = minutes_at(table, x, push_pull);
+            CHECK(y <= previous + 1e-4f);
+            CHECK(y >= minutes[i + 1] - 1e-4f);
+            previous = y;
+        }
+    }
+}
+
+void keeps_shape_of_the_data() {
+    for(float push_pull : PUSH_PULL) {
+        stays_monotone_within_cells(TABLE, push_pull);
+    }
+
+    // The plateau stays flat and the drop does not undershoot its floor
+    for(int step = 0; step <= 200; step++) {
+        float x = step / 40.0f;
+        float y = minutes_at(STEP_TABLE, x);
+        if(x <= 2) {
+            CHECK_NEAR(y, 10.0, 1e-5);
+        } else {
+            CHECK(y <= 10.0f && y >= 1.0f);
+        }
+    }
+}
+
+void reports_missing_times() {
+    // Outside the grid
+    CHECK(minutes_at(TABLE, 74.9f) < 0);
+    CHECK(minutes_at(TABLE, 102.1f) < 0);
+    CHECK(minutes_at(TABLE, 85, 3.5f) < 0);
+    // Cells with no time, and the intervals and blends next to them
+    CHECK(minutes_at(TABLE, 75, 2) < 0);
+    CHECK(minutes_at(TABLE, 77, 2) < 0);
+    CHECK(minutes_at(TABLE, 82, 3) < 0);
+    CHECK(minutes_at(TABLE, 80, 2.5f) < 0);
+    CHECK(minutes_at(TABLE, 80, 2) > 0);
+    CHECK(minutes_at(TABLE, 85, 2.5f) > 0);
+}
+
+void blends_other_axes_linearly() {
+    CHECK_NEAR(minutes_at(TABLE, 85, 0.5f), (13.0 + 17.0) / 2, 1e-4);
+    CHECK_NEAR(
+        minutes_at(TABLE, 87, 0.25f),
+        0.75 * minutes_at(TABLE, 87, 0) + 0.25 * minutes_at(TABLE, 87, 1),
+        1e-4);
+    // Each roll before this one adds 2%, compounding
+    CHECK_NEAR(dev_time_minutes(TABLE, {85, 0, 0, 3}), 13.0 * 1.02 * 1.02, 1e-4);
+    CHECK_NEAR(calculate_dev_time_ms(TABLE, 85, 0, 1), 13.0 * 60 * 1000, 0.5);
+}
+
+void curve_follows_the_table() {
+    DevTimeCurve curve;
+    // Only a temperature first axis makes a curve
+    DevTimeTable by_push = STEP_TABLE;
+    by_push.axes[0].kind = DevTimeAxisKind::PushPull;
+    CHECK(!curve.select(&by_push, {0, 0, 0, 1}));
+    CHECK(curve.minutes_at(1) < 0);
+
+    CHECK(curve.select(&TABLE, {0, 1, 0, 1}));
+    // Drifting up and back down across grid points
+    for(int step = 0; step <= 540; step++) {
+        float x = step <= 270 ? 75 + step / 10.0f : 102 - (step - 270) / 10.0f;
+        CHECK_NEAR(curve.minutes_at(x), minutes_at(TABLE, x, 1), 1e-5);
+    }
+    CHECK(curve.minutes_at(110) < 0);
+    CHECK_NEAR(curve.minutes_at(85), 17.0, 1e-4);
+
+    // Push 3 has no time below 85
+    CHECK(curve.select(&TABLE, {0, 3, 0, 1}));
+    CHECK(curve.minutes_at(80) < 0);
+    CHECK_NEAR(curve.minutes_at(90), 21.0, 1e-4);
+}
+
+void loads_the_same_table_from_text() {
+    const char* lines[] = {
+        "# CineStill Cs41",
+        "unit fahrenheit",
+        "axis temperature 75 80 85 90 95 102",
+        "axis push_pull -1 0 1 2 3",
+        "exhaustion 0.02",
+        "minutes 27 16.25 10 6.5 4.5 2.75",
+        "minutes 35 21 13 8.5 5.75 3.5",
+        "minutes 50 28 17 11 7.5 4.55",
+        "minutes - 37 25 14.75 10 6.13",
+        "minutes - - 35 21 14.33 8.75",
+    };
+    static LoadedDevTimeTable loaded;
+    bool ok = true;
+    for(const char* text : lines) {
+        char line[LoadedDevTimeTable::MAX_LINE];
+        snprintf(line, sizeof(line), "%s", text);
+        ok = ok && loaded.parse_line(line);
+    }
+    CHECK(ok && loaded.finish());
+    const DevTimeTable* table = loaded.get();
+    CHECK(table != nullptr);
+    if(!table) {
+        return;
+    }
+    CHECK(table->fahrenheit);
+    for(size_t cell = 0; cell < COUNT_OF(MINUTES); cell++) {
+        CHECK(table->minutes[cell] == MINUTES[cell]);
+        CHECK_NEAR(table->slopes[cell], SLOPES[cell], 1e-6);
+    }
+}
+
+} // namespace
+
+int main() {
+    passes_through_the_grid();
+    keeps_shape_of_the_data();
+    reports_missing_times();
+    blends_other_axes_linearly();
+    curve_follows_the_table();
+    loads_the_same_table_from_text();
+    return check_result();
+}
@@ -0,0 +1,122 @@
+#include "check.hpp"
+#include "heater_controller.hpp"
+
+/**
+ * Closes the loop of HeaterController on a SimulatedBath, on the virtual
+ * kernel tick: each period the probe is sampled into the feed, control()
+ * runs and its power goes to the element, as the controller thread does
+ * with a proportional output.
+ */
+
+namespace {
+
+constexpr uint32_t PERIOD_MS = HeaterController::DEFAULT_PERIOD_MS;
+constexpr uint32_t MINUTE_MS = 60 * 1000;
+
+struct Rig {
+    SimulatedBath bath;
+    TemperatureFeed feed;
+    HeaterController heater{bath, feed};
+    uint32_t samples = 0;
+    float celsius = 0;
+    float power = 0;
+
+    explicit Rig(float start_celsius)
+        : bath(start_celsius) {
+        // The bath starts integrating at its first non-zero tick
+        host_advance_tick(1);
+        bath.setPower(0);
+    }
+
+    void sample() {
+        bath.sample(celsius);
+        feed.publish({celsius, furi_get_tick(), ++samples, true});
+    }
+
+    // One controller period
+    void run_period() {
+        host_advance_tick(PERIOD_MS);
+        sample();
+        power = heater.control(furi_get_tick());
+        bath.setPower(power);
+    }
+};
+
+void reaches_steady_state() {
+    Rig rig(20.0f);
+    rig.heater.setTarget(38.0f);
+    float peak = 0;
+    uint32_t reached_at = 0;
+    for(uint32_t t = 0; t < 120 * MINUTE_MS; t += PERIOD_MS) {
+        rig.run_period();
+        peak = rig.celsius > peak ? rig.celsius : peak;
+        if(reached_at == 0 && rig.celsius >= 37.8f) {
+            reached_at = t;
+        }
+    }
+    CHECK(reached_at > 0);
+    CHECK(reached_at < 60 * MINUTE_MS);
+    CHECK(peak < 38.0f + 0.5f);
+
+    // Holding: the last half hour stays on target with the element partly on
+    float lowest = 100, highest = 0, power_sum = 0;
+    uint32_t periods = 0;
+    for(uint32_t t = 0; t < 30 * MINUTE_MS; t += PERIOD_MS) {
+        rig.run_period();
+        lowest = rig.celsius < lowest ? rig.celsius : lowest;
+        highest = rig.celsius > highest ? rig.celsius : highest;
+        power_sum += rig.power;
+        periods++;
+    }
+    CHECK_NEAR(lowest, 38.0, 0.3);
+    CHECK_NEAR(highest, 38.0, 0.3);
+    // Losses of 3 W per degree over 18 degrees, from a 300 W element
+    CHECK_NEAR(power_sum / periods, 54.0 / 300.0, 0.05);
+}
+
+void cuts_off_above_the_target() {
+    Rig rig(45.0f);
+    rig.heater.setTarget(38.0f);
+    bool cut_off = true;
+    for(uint32_t t = 0; t < 60 * MINUTE_MS; t += PERIOD_MS) {
+        rig.run_period();
+        if(rig.celsius > 38.0f + HeaterController::MAX_OVERSHOOT && rig.power != 0) {
+            cut_off = false;
+        }
+    }
+    CHECK(cut_off);
+    // The bath cooled below the cutoff meanwhile, and the PID took over
+    CHECK(rig.celsius < 38.0f + HeaterController::MAX_OVERSHOOT);
+}
+
+void stays_off_without_a_target_or_reading() {
+    Rig rig(20.0f);
+    rig.run_period();
+    CHECK(rig.power == 0);
+
+    rig.heater.setTarget(38.0f);
+    rig.run_period();
+    CHECK(rig.power > 0);
+
+    // A reading older than MAX_READING_AGE_MS
+    host_advance_tick(HeaterController::MAX_READING_AGE_MS + 1);
+    CHECK(rig.heater.control(furi_get_tick()) == 0);
+
+    rig.sample();
+    CHECK(rig.heater.control(furi_get_tick()) > 0);
+    rig.feed.publish({20.0f, furi_get_tick(), rig.samples, false});
+    CHECK(rig.heater.control(furi_get_tick()) == 0);
+
+    rig.sample();
+    rig.heater.setMode(HeaterController::Mode::Off);
+    CHECK(rig.heater.control(furi_get_tick()) == 0);
+}
+
+} // namespace
+
+int main() {
+    reaches_steady_state();
+    cuts_off_above_the_target();
+    stays_off_without_a_target_or_reading();
+    return check_result();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+/**
+ * @brief The parts of the Flipper SDK the tested headers use, for host
+ * test runs.
+ *
+ * Kernel ticks are milliseconds of a virtual clock that only moves when a
+ * test calls host_advance_tick(), so a test can run an hour of a water bath
+ * in a few milliseconds. There are no furi threads: code that would start
+ * one crashes, tests drive the loops themselves.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define FURI_LOG_E(tag, format, ...) host_log('E', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) host_log('W', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) host_log('I', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) host_log('D', tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) host_log('T', tag, format, ##__VA_ARGS__)
+
+#define UNUSED(x) (void)(x)
+#define COUNT_OF(x) (sizeof(x) / sizeof(x[0]))
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+typedef enum {
+    FuriFlagWaitAny = 0,
+    FuriFlagWaitAll = 1,
+    FuriFlagNoClear = 2,
+    FuriFlagError = (int)0x80000000U,
+} FuriFlag;
+
+typedef enum {
+    FuriThreadPriorityLow = 1,
+    FuriThreadPriorityNormal = 16,
+    FuriThreadPriorityHigh = 17,
+} FuriThreadPriority;
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriThread FuriThread;
+typedef struct FuriString FuriString;
+typedef void* FuriThreadId;
+typedef int32_t (*FuriThreadCallback)(void* context);
+
+// Errors and warnings go to stderr, the rest is dropped
+void host_log(char level, const char* tag, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// Moves the kernel tick, the only thing that does
+void host_advance_tick(uint32_t ms);
+
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+void furi_delay_ms(uint32_t milliseconds);
+
+FuriMutex* furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex* mutex);
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex* mutex);
+
+FuriThread* furi_thread_alloc_ex(
+    const char* name,
+    uint32_t stack_size,
+    FuriThreadCallback callback,
+    void* context);
+void furi_thread_free(FuriThread* thread);
+void furi_thread_set_priority(FuriThread* thread, FuriThreadPriority priority);
+void furi_thread_start(FuriThread* thread);
+bool furi_thread_join(FuriThread* thread);
+FuriThreadId furi_thread_get_id(FuriThread* thread);
+// Tells apart the test's std::threads
+FuriThreadId furi_thread_get_current_id(void);
+uint32_t furi_thread_get_stack_space(FuriThreadId thread_id);
+uint32_t furi_thread_flags_set(FuriThreadId thread_id, uint32_t flags);
+uint32_t furi_thread_flags_wait(uint32_t flags, uint32_t options, uint32_t timeout);
+
+void furi_crash(const char* message);
+
+// The host heap is not measured, both report 0
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_minimum_free_heap(void);
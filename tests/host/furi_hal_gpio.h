@@ -0,0 +1,4 @@
+#pragma once
+
+// Included with furi.h by host_helpers.hpp, nothing the tested code calls
+#include <furi.h>
@@ -0,0 +1,111 @@
+#include <furi.h>
+#include <mutex>
+#include <stdarg.h>
+#include <stdlib.h>
+
+namespace {
+uint32_t tick = 0;
+} // namespace
+
+void host_log(char level, const char* tag, const char* format, ...) {
+    if(level != 'E' && level != 'W') {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "[%c][%s] ", level, tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+void host_advance_tick(uint32_t ms) {
+    tick += ms;
+}
+
+uint32_t furi_get_tick(void) {
+    return tick;
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    host_advance_tick(milliseconds);
+}
+
+struct FuriMutex {
+    std::recursive_mutex mutex;
+};
+
+FuriMutex* furi_mutex_alloc(FuriMutexType) {
+    return new FuriMutex;
+}
+
+void furi_mutex_free(FuriMutex* mutex) {
+    delete mutex;
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex* mutex, uint32_t) {
+    mutex->mutex.lock();
+    return FuriStatusOk;
+}
+
+FuriStatus furi_mutex_release(FuriMutex* mutex) {
+    mutex->mutex.unlock();
+    return FuriStatusOk;
+}
+
+FuriThread* furi_thread_alloc_ex(const char* name, uint32_t, FuriThreadCallback, void*) {
+    fprintf(stderr, "No thread %s in host tests\n", name);
+    furi_crash("furi_thread_alloc_ex");
+    return nullptr;
+}
+
+void furi_thread_free(FuriThread*) {
+}
+
+void furi_thread_set_priority(FuriThread*, FuriThreadPriority) {
+}
+
+void furi_thread_start(FuriThread*) {
+}
+
+bool furi_thread_join(FuriThread*) {
+    return true;
+}
+
+FuriThreadId furi_thread_get_id(FuriThread* thread) {
+    return thread;
+}
+
+FuriThreadId furi_thread_get_current_id(void) {
+    static thread_local char self;
+    return &self;
+}
+
+uint32_t furi_thread_get_stack_space(FuriThreadId) {
+    return 0;
+}
+
+uint32_t furi_thread_flags_set(FuriThreadId, uint32_t flags) {
+    return flags;
+}
+
+uint32_t furi_thread_flags_wait(uint32_t, uint32_t, uint32_t) {
+    return FuriFlagError;
+}
+
+void furi_crash(const char* message) {
+    fprintf(stderr, "furi_crash: %s\n", message);
+    abort();
+}
+
+size_t memmgr_get_free_heap(void) {
+    return 0;
+}
+
+size_t memmgr_get_minimum_free_heap(void) {
+    return 0;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @brief The storage calls the tested headers use, on the host file system.
+ *
+ * Paths are moved under the directory given to host_storage_root(), with
+ * /data/ standing for the app's data directory, so a test works on a
+ * scratch copy of the SD card.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RECORD_STORAGE "storage"
+#define APP_DATA_PATH(path) "/data/" path
+#define EXT_PATH(path) "/ext/" path
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+typedef enum {
+    FSAM_READ = 1,
+    FSAM_WRITE = 2,
+    FSAM_READ_WRITE = 3,
+} FS_AccessMode;
+
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+
+typedef enum {
+    FSE_OK = 0,
+    FSE_NOT_READY,
+    FSE_EXIST,
+    FSE_NOT_EXIST,
+    FSE_INVALID_PARAMETER,
+    FSE_DENIED,
+    FSE_INVALID_NAME,
+    FSE_INTERNAL,
+    FSE_NOT_IMPLEMENTED,
+    FSE_ALREADY_OPEN,
+} FS_Error;
+
+typedef enum {
+    FSF_DIRECTORY = (1 << 0),
+} FS_Flags;
+
+typedef struct {
+    uint8_t flags;
+    uint64_t size;
+} FileInfo;
+
+// Host only: the directory that stands for the root of the card
+void host_storage_root(const char* directory);
+// Host only: files opened so far whose path ends in extension
+uint32_t host_storage_opened(const char* extension);
+
+File* storage_file_alloc(Storage* storage);
+void storage_file_free(File* file);
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File* file);
+bool storage_file_is_open(File* file);
+size_t storage_file_read(File* file, void* buffer, size_t bytes_to_read);
+size_t storage_file_write(File* file, const void* buffer, size_t bytes_to_write);
+bool storage_file_seek(File* file, uint32_t offset, bool from_start);
+
+bool storage_dir_open(File* file, const char* path);
+bool storage_dir_close(File* file);
+bool storage_dir_read(File* file, FileInfo* info, char* name, uint16_t name_length);
+
+FS_Error storage_common_timestamp(Storage* storage, const char* path, uint32_t* timestamp);
+FS_Error storage_common_rename(Storage* storage, const char* old_path, const char* new_path);
+FS_Error storage_common_remove(Storage* storage, const char* path);
+bool storage_simply_mkdir(Storage* storage, const char* path);
+bool file_info_is_dir(const FileInfo* info);
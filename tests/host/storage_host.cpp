@@ -0,0 +1,156 @@
+#include <storage/storage.h>
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+namespace {
+std::string root = ".";
+std::vector<std::string> opened;
+
+std::string host_path(const char* path) {
+    std::string mapped(path);
+    if(mapped.rfind("/data/", 0) == 0) {
+        return root + "/data/" + mapped.substr(6);
+    }
+    if(mapped.rfind("/ext/", 0) == 0) {
+        return root + "/" + mapped.substr(5);
+    }
+    return root + "/" + mapped;
+}
+} // namespace
+
+struct File {
+    FILE* file = nullptr;
+    DIR* directory = nullptr;
+    std::string directory_path;
+};
+
+void host_storage_root(const char* directory) {
+    root = directory;
+}
+
+uint32_t host_storage_opened(const char* extension) {
+    size_t length = strlen(extension);
+    uint32_t count = 0;
+    for(const std::string& path : opened) {
+        if(path.size() >= length && path.compare(path.size() - length, length, extension) == 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+File* storage_file_alloc(Storage*) {
+    return new File;
+}
+
+void storage_file_free(File* file) {
+    storage_file_close(file);
+    storage_dir_close(file);
+    delete file;
+}
+
+bool storage_file_open(File* file, const char* path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    const char* mode = open_mode == FSOM_CREATE_ALWAYS ? "w+b" :
+                       access_mode == FSAM_READ        ? "rb" :
+                                                         "r+b";
+    opened.push_back(path);
+    file->file = fopen(host_path(path).c_str(), mode);
+    return file->file != nullptr;
+}
+
+bool storage_file_close(File* file) {
+    if(!file->file) {
+        return false;
+    }
+    fclose(file->file);
+    file->file = nullptr;
+    return true;
+}
+
+bool storage_file_is_open(File* file) {
+    return file->file != nullptr;
+}
+
+size_t storage_file_read(File* file, void* buffer, size_t bytes_to_read) {
+    return file->file ? fread(buffer, 1, bytes_to_read, file->file) : 0;
+}
+
+size_t storage_file_write(File* file, const void* buffer, size_t bytes_to_write) {
+    return file->file ? fwrite(buffer, 1, bytes_to_write, file->file) : 0;
+}
+
+bool storage_file_seek(File* file, uint32_t offset, bool from_start) {
+    return file->file && fseek(file->file, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+bool storage_dir_open(File* file, const char* path) {
+    file->directory_path = host_path(path);
+    file->directory = opendir(file->directory_path.c_str());
+    return file->directory != nullptr;
+}
+
+bool storage_dir_close(File* file) {
+    if(!file->directory) {
+        return false;
+    }
+    closedir(file->directory);
+    file->directory = nullptr;
+    return true;
+}
+
+bool storage_dir_read(File* file, FileInfo* info, char* name, uint16_t name_length) {
+    if(!file->directory) {
+        return false;
+    }
+    while(dirent* entry = readdir(file->directory)) {
+        if(strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+        struct stat status;
+        if(stat((file->directory_path + "/" + entry->d_name).c_str(), &status) != 0) {
+            continue;
+        }
+        info->flags = S_ISDIR(status.st_mode) ? FSF_DIRECTORY : 0;
+        info->size = status.st_size;
+        snprintf(name, name_length, "%s", entry->d_name);
+        return true;
+    }
+    return false;
+}
+
+FS_Error storage_common_timestamp(Storage*, const char* path, uint32_t* timestamp) {
+    struct stat status;
+    if(stat(host_path(path).c_str(), &status) != 0) {
+        return FSE_NOT_EXIST;
+    }
+    *timestamp = status.st_mtime;
+    return FSE_OK;
+}
+
+FS_Error storage_common_rename(Storage*, const char* old_path, const char* new_path) {
+    return rename(host_path(old_path).c_str(), host_path(new_path).c_str()) == 0 ? FSE_OK :
+                                                                                  FSE_NOT_EXIST;
+}
+
+FS_Error storage_common_remove(Storage*, const char* path) {
+    return remove(host_path(path).c_str()) == 0 ? FSE_OK : FSE_NOT_EXIST;
+}
+
+bool storage_simply_mkdir(Storage*, const char* path) {
+    std::string directory = host_path(path);
+    // Parents first, as the card has /data already
+    for(size_t slash = directory.find('/', 1); slash != std::string::npos;
+        slash = directory.find('/', slash + 1)) {
+        mkdir(directory.substr(0, slash).c_str(), 0755);
+    }
+    return mkdir(directory.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool file_info_is_dir(const FileInfo* info) {
+    return info->flags & FSF_DIRECTORY;
+}
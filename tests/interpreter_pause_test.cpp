@@ -0,0 +1,106 @@
+#include "check.hpp"
+#include "agitation/interpreter.hpp"
+
+/**
+ * Pauses built-in processes mid-step on VirtualClock and checks the motor
+ * picks up after resume() as if the pause had not happened: the same
+ * direction at the same step time, and the step no shorter or longer.
+ */
+
+namespace {
+
+using HostInterpreter = Interpreter<VirtualClock, RecordingMotor>;
+
+constexpr uint32_t TICK_MS = 100;
+constexpr uint32_t SECOND_MS = 1000;
+
+struct Rig {
+    RecordingMotor motor;
+    HostInterpreter interpreter{motor};
+
+    explicit Rig(size_t process) {
+        interpreter.selectProcess(process);
+        interpreter.start();
+    }
+
+    void run(uint32_t ms) {
+        for(uint32_t ran = 0; ran < ms && interpreter.getState() == ProcessState::Running;
+            ran += TICK_MS) {
+            interpreter.getClock().advance(TICK_MS);
+            interpreter.tick();
+        }
+    }
+
+    void pause_for(uint32_t ms) {
+        if(interpreter.getState() != ProcessState::Running) {
+            return;
+        }
+        interpreter.pause();
+        interpreter.getClock().advance(ms);
+        interpreter.resume();
+    }
+};
+
+// Processes whose steps have no sequence and turn clockwise throughout
+void empty_sequences_turn_again_after_resume() {
+    for(size_t process = 0; process < AGITATION_PROCESS_COUNT; process++) {
+        Rig rig(process);
+        if(AGITATION_PROCESSES[process]->steps[0].sequence.length > 0) {
+            continue;
+        }
+        CHECK(rig.motor.isClockwise());
+        rig.run(5 * SECOND_MS);
+        uint32_t remaining = rig.interpreter.getCurrentMovementTimeRemaining();
+
+        rig.interpreter.pause();
+        CHECK(rig.motor.isStopped());
+        rig.interpreter.getClock().advance(60 * SECOND_MS);
+        rig.interpreter.resume();
+        CHECK(rig.motor.isClockwise());
+        // The pause does not count towards the step
+        CHECK(rig.interpreter.getCurrentMovementTimeRemaining() == remaining);
+
+        rig.run(remaining - TICK_MS);
+        CHECK(rig.interpreter.getState() == ProcessState::Running);
+        CHECK(rig.motor.isClockwise());
+        rig.run(TICK_MS);
+        CHECK(rig.interpreter.getState() != ProcessState::Running);
+        CHECK(rig.motor.isStopped());
+    }
+}
+
+// Ticks a paused run and one that never paused at the same step times
+void sequences_resume_where_they_left_off() {
+    for(size_t process = 0; process < AGITATION_PROCESS_COUNT; process++) {
+        if(AGITATION_PROCESSES[process]->steps[0].sequence.length == 0) {
+            continue;
+        }
+        Rig steady(process);
+        Rig paused(process);
+        bool same = true;
+        // Pauses land at every phase of the sequence, across steps
+        for(int pause = 0; pause < 12 && paused.interpreter.getState() == ProcessState::Running;
+            pause++) {
+            steady.run(4700);
+            paused.run(4700);
+            paused.pause_for(7300);
+            same = same && paused.motor.getDirection() == steady.motor.getDirection();
+        }
+        for(uint32_t t = 0; t < 30 * SECOND_MS; t += TICK_MS) {
+            steady.run(TICK_MS);
+            paused.run(TICK_MS);
+            same = same && paused.motor.getDirection() == steady.motor.getDirection() &&
+                   paused.interpreter.getCurrentMovementTimeElapsed() ==
+                       steady.interpreter.getCurrentMovementTimeElapsed();
+        }
+        CHECK(same);
+    }
+}
+
+} // namespace
+
+int main() {
+    empty_sequences_turn_again_after_resume();
+    sequences_resume_where_they_left_off();
+    return check_result();
+}
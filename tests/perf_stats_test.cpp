@@ -0,0 +1,96 @@
+#include "check.hpp"
+#include "instrumentation.hpp"
+#include <atomic>
+#include <thread>
+
+/**
+ * Records PerfStats probes from two threads, standing for the app and GUI
+ * threads, while a third reads them as the debug view does: every copy
+ * must add up, and nothing recorded may be lost.
+ */
+
+namespace {
+
+constexpr uint32_t SAMPLES = 500000;
+// Every sample of a probe takes the same time, so a record is consistent
+// when its total is its count times that
+constexpr uint32_t SHARED_TICKS = 1000;
+constexpr uint32_t APP_TICKS = 40;
+constexpr uint32_t DRAW_TICKS = 70000;
+
+const char* const SHARED = "Lock wait";
+const char* const APP = "App update";
+const char* const DRAW = "Main draw";
+
+uint32_t ticks_of(const char* name) {
+    return name == SHARED ? SHARED_TICKS : name == APP ? APP_TICKS : DRAW_TICKS;
+}
+
+bool consistent(const PerfStats::Record& record) {
+    uint32_t ticks = ticks_of(record.name);
+    // Buckets are halved as they fill, but only the one bucket of the
+    // samples' time has any
+    size_t bucket = 31 - __builtin_clz(ticks);
+    uint32_t elsewhere = 0;
+    for(size_t i = 0; i < PerfStats::BUCKETS; i++) {
+        elsewhere += i == bucket ? 0 : record.buckets[i];
+    }
+    return record.count > 0 && record.total == uint64_t(record.count) * ticks &&
+           record.min == ticks && record.max == ticks && record.buckets[bucket] > 0 &&
+           elsewhere == 0;
+}
+
+void records_from_two_threads() {
+    std::atomic<int> running{2};
+    auto recorder = [&](const char* own) {
+        for(uint32_t i = 0; i < SAMPLES; i++) {
+            PerfStats::record(SHARED, SHARED_TICKS);
+            PerfStats::record(own, ticks_of(own));
+        }
+        running--;
+    };
+    std::thread app(recorder, APP);
+    std::thread gui(recorder, DRAW);
+
+    uint32_t torn = 0;
+    uint32_t reads = 0;
+    uint32_t last_shared = 0;
+    while(running > 0) {
+        PerfStats::Record record;
+        for(size_t i = 0; PerfStats::get(i, record); i++) {
+            torn += consistent(record) ? 0 : 1;
+            if(record.name == SHARED) {
+                torn += record.count < last_shared ? 1 : 0;
+                last_shared = record.count;
+            }
+            reads++;
+        }
+    }
+    app.join();
+    gui.join();
+    CHECK(torn == 0);
+    CHECK(reads > 0);
+
+    // One line per probe, the shared one adding up both threads
+    CHECK(PerfStats::get_count() == 3);
+    PerfStats::Record record;
+    for(size_t i = 0; PerfStats::get(i, record); i++) {
+        CHECK(consistent(record));
+        CHECK(record.count == (record.name == SHARED ? 2 * SAMPLES : SAMPLES));
+        CHECK(record.p99() == ticks_of(record.name));
+    }
+}
+
+void drops_threads_beyond_the_tables() {
+    // Both tables are taken by the threads above
+    PerfStats::record("Late", 1);
+    CHECK(PerfStats::get_count() == 3);
+}
+
+} // namespace
+
+int main() {
+    records_from_two_threads();
+    drops_threads_beyond_the_tables();
+    return check_result();
+}
@@ -0,0 +1,220 @@
+#include "check.hpp"
+#include "agitation/process_library.hpp"
+#include <filesystem>
+#include <string>
+
+/**
+ * Builds recipe folders on a scratch card and checks the index the
+ * library keeps of them: its header and tables, that reopening parses
+ * nothing, that a change parses only what changed, and which files are
+ * left out.
+ */
+
+namespace {
+
+namespace fs = std::filesystem;
+
+const fs::path CARD = "process_library_card";
+const fs::path RECIPES = CARD / "data" / "processes";
+
+// Several kilobytes, as on the device
+ProcessLibrary library;
+
+struct IndexFile {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t count;
+    uint32_t bucket_count;
+};
+
+void fresh_card() {
+    fs::remove_all(CARD);
+    fs::create_directories(RECIPES);
+    host_storage_root(CARD.c_str());
+}
+
+void put(const std::string& file, const std::string& text) {
+    FILE* out = fopen((RECIPES / file).c_str(), "w");
+    fputs(text.c_str(), out);
+    fclose(out);
+}
+
+void put_recipe(const std::string& file, const std::string& name, int seconds) {
+    put(file,
+        "name " + name + "\nfilm Test Film\nchemistry Test\nstep Only\nseconds " +
+            std::to_string(seconds) + "\n");
+}
+
+IndexFile read_index_header() {
+    IndexFile header{};
+    FILE* in = fopen((RECIPES / ".index").c_str(), "rb");
+    if(in) {
+        if(fread(&header, sizeof(header), 1, in) != 1) {
+            header = IndexFile{};
+        }
+        fclose(in);
+    }
+    return header;
+}
+
+// Recipes parsed by the next call, counted as opens of recipe files
+struct ParseCounter {
+    uint32_t before = host_storage_opened(ProcessLibrary::EXTENSION);
+    uint32_t parsed() const {
+        return host_storage_opened(ProcessLibrary::EXTENSION) - before;
+    }
+};
+
+bool has_recipe(const char* name, size_t* entry = nullptr) {
+    size_t found = 0;
+    bool ok = library.find(name, found);
+    if(entry) {
+        *entry = found;
+    }
+    return ok;
+}
+
+void indexes_the_recipes() {
+    fresh_card();
+    put_recipe("stand.fdp", "Stand", 90);
+    put_recipe("fix.fdp", "Fix", 300);
+    put("broken.fdp", "name Broken\nstep Only\nbogus 3\n");
+    // Left out: a name too long for a record, hidden files, other files
+    put_recipe("a_recipe_with_a_very_long_name.fdp", "Long", 10);
+    put_recipe(".hidden.fdp", "Hidden", 10);
+    put("notes.txt", "not a recipe\n");
+
+    ParseCounter counter;
+    CHECK(library.open(nullptr));
+    CHECK(counter.parsed() == 3);
+    CHECK(library.get_count() == AGITATION_PROCESS_COUNT + 3);
+
+    IndexFile header = read_index_header();
+    CHECK(memcmp(&header.magic, "FDPI", 4) == 0);
+    CHECK(header.version == 2);
+    CHECK(header.count == 3);
+    // A power of two at least twice the count
+    CHECK(header.bucket_count >= 6 && (header.bucket_count & (header.bucket_count - 1)) == 0);
+    CHECK(
+        fs::file_size(RECIPES / ".index") ==
+        sizeof(IndexFile) + 3 * header.record_size + 2 * header.bucket_count * sizeof(uint16_t));
+
+    size_t entry = 0;
+    ProcessSummary summary;
+    CHECK(has_recipe("Stand", &entry));
+    CHECK(entry >= AGITATION_PROCESS_COUNT);
+    CHECK(library.get_summary(entry, summary));
+    CHECK(strcmp(summary.film, "Test Film") == 0);
+    CHECK(summary.step_count == 1);
+    CHECK(summary.duration_ms == 90 * 1000);
+    const AgitationProcessStatic* process = library.load(entry);
+    CHECK(process && strcmp(process->process_name, "Stand") == 0);
+
+    // Listed by file name with the line it failed on
+    CHECK(has_recipe("broken.fdp", &entry));
+    CHECK(library.get_summary(entry, summary));
+    CHECK(strcmp(summary.film, "Error on line 3") == 0);
+    CHECK(summary.step_count == 0);
+
+    CHECK(!has_recipe("Long"));
+    CHECK(!has_recipe("Hidden"));
+    // Built-in processes come first
+    CHECK(has_recipe(AGITATION_PROCESSES[0]->process_name, &entry) && entry == 0);
+}
+
+void reopens_without_parsing() {
+    fresh_card();
+    for(int i = 0; i < 20; i++) {
+        put_recipe("r" + std::to_string(i) + ".fdp", "Recipe " + std::to_string(i), i + 1);
+    }
+    CHECK(library.open(nullptr));
+    auto written = fs::last_write_time(RECIPES / ".index");
+
+    ParseCounter counter;
+    CHECK(library.open(nullptr));
+    CHECK(counter.parsed() == 0);
+    CHECK(fs::last_write_time(RECIPES / ".index") == written);
+    CHECK(library.get_count() == AGITATION_PROCESS_COUNT + 20);
+    for(int i = 0; i < 20; i++) {
+        CHECK(has_recipe(("Recipe " + std::to_string(i)).c_str()));
+    }
+
+    // A stale or foreign index is rebuilt from the recipes
+    FILE* index = fopen((RECIPES / ".index").c_str(), "r+b");
+    uint16_t old_version = 1;
+    fseek(index, offsetof(IndexFile, version), SEEK_SET);
+    fwrite(&old_version, sizeof(old_version), 1, index);
+    fclose(index);
+    ParseCounter rebuilt;
+    CHECK(library.open(nullptr));
+    CHECK(rebuilt.parsed() == 20);
+    CHECK(read_index_header().version == 2);
+}
+
+void parses_only_what_changed() {
+    fresh_card();
+    for(int i = 0; i < 10; i++) {
+        put_recipe("r" + std::to_string(i) + ".fdp", "Recipe " + std::to_string(i), i + 1);
+    }
+    CHECK(library.open(nullptr));
+
+    // A size change is seen even within the card's second of resolution
+    put_recipe("r3.fdp", "Recipe 3 renamed", 30);
+    fs::remove(RECIPES / "r5.fdp");
+    put_recipe("new.fdp", "Newcomer", 5);
+
+    ParseCounter counter;
+    CHECK(library.open(nullptr));
+    CHECK(counter.parsed() == 2);
+    CHECK(library.get_count() == AGITATION_PROCESS_COUNT + 10);
+    CHECK(!has_recipe("Recipe 3"));
+    CHECK(!has_recipe("Recipe 5"));
+    CHECK(has_recipe("Recipe 3 renamed"));
+    CHECK(has_recipe("Newcomer"));
+    // Kept records still point at their own recipes
+    size_t entry = 0;
+    ProcessSummary summary;
+    CHECK(has_recipe("Recipe 7", &entry));
+    CHECK(library.get_summary(entry, summary) && summary.duration_ms == 8 * 1000);
+}
+
+void stops_at_max_recipes() {
+    fresh_card();
+    size_t total = ProcessLibrary::MAX_RECIPES + 6;
+    for(size_t i = 0; i < total; i++) {
+        put_recipe("r" + std::to_string(i) + ".fdp", "Recipe " + std::to_string(i), 1);
+    }
+    CHECK(library.open(nullptr));
+    CHECK(library.get_count() == AGITATION_PROCESS_COUNT + ProcessLibrary::MAX_RECIPES);
+    CHECK(read_index_header().count == ProcessLibrary::MAX_RECIPES);
+
+    size_t found = 0;
+    for(size_t i = 0; i < total; i++) {
+        found += has_recipe(("Recipe " + std::to_string(i)).c_str()) ? 1 : 0;
+    }
+    CHECK(found == ProcessLibrary::MAX_RECIPES);
+
+    // The recipes left out do not make the index look stale
+    ParseCounter counter;
+    CHECK(library.open(nullptr));
+    CHECK(counter.parsed() == 0);
+
+    size_t visited = 0;
+    library.for_each_summary(0, library.get_count(), [&](size_t, const ProcessSummary&) {
+        visited++;
+    });
+    CHECK(visited == library.get_count());
+}
+
+} // namespace
+
+int main() {
+    indexes_the_recipes();
+    reopens_without_parsing();
+    parses_only_what_changed();
+    stops_at_max_recipes();
+    library.close();
+    fs::remove_all(CARD);
+    return check_result();
+}
@@ -0,0 +1,117 @@
+#include "check.hpp"
+#include "temperature_sensor.hpp"
+#include <atomic>
+#include <thread>
+
+/**
+ * Hammers a TemperatureFeed from real threads, as the sampler thread and
+ * the dispatcher and GUI threads do on the device but without the time
+ * slicing: a reader that ever mixes fields of two readings fails. Also
+ * checks the filters the sampler smooths readings with.
+ */
+
+namespace {
+
+constexpr uint32_t PUBLISHES = 2000000;
+constexpr int READERS = 3;
+
+// Every field derives from one counter, so a torn copy shows
+TemperatureReading reading_for(uint32_t count) {
+    return {static_cast<float>(count % 65536), count * 7, count, count % 3 != 0};
+}
+
+bool consistent(const TemperatureReading& reading) {
+    TemperatureReading expected = reading_for(reading.samples);
+    return reading.celsius == expected.celsius && reading.taken_at == expected.taken_at &&
+           reading.valid == expected.valid;
+}
+
+void readers_never_see_a_torn_reading() {
+    TemperatureFeed feed;
+    feed.publish(reading_for(0));
+    std::atomic<bool> done{false};
+    std::atomic<uint32_t> torn{0};
+    std::atomic<uint32_t> backwards{0};
+    std::atomic<uint32_t> reads{0};
+
+    std::thread readers[READERS];
+    for(std::thread& reader : readers) {
+        reader = std::thread([&] {
+            uint32_t last = 0;
+            uint32_t count = 0;
+            while(!done.load(std::memory_order_relaxed)) {
+                TemperatureReading reading = feed.read();
+                if(!consistent(reading)) {
+                    torn++;
+                }
+                if(reading.samples < last) {
+                    backwards++;
+                }
+                last = reading.samples;
+                count++;
+            }
+            reads += count;
+        });
+    }
+    std::thread writer([&] {
+        for(uint32_t count = 1; count <= PUBLISHES; count++) {
+            feed.publish(reading_for(count));
+        }
+        done = true;
+    });
+
+    writer.join();
+    for(std::thread& reader : readers) {
+        reader.join();
+    }
+    CHECK(torn == 0);
+    CHECK(backwards == 0);
+    CHECK(reads > 0);
+    CHECK(feed.read().samples == PUBLISHES);
+}
+
+void moving_average_fills_then_slides() {
+    MovingAverageFilter<4> filter;
+    CHECK_NEAR(filter.update(10), 10.0, 1e-6);
+    CHECK_NEAR(filter.update(20), 15.0, 1e-6);
+    CHECK_NEAR(filter.update(30), 20.0, 1e-6);
+    CHECK_NEAR(filter.update(40), 25.0, 1e-6);
+    // 10 leaves the window
+    CHECK_NEAR(filter.update(50), 35.0, 1e-6);
+    filter.reset();
+    CHECK_NEAR(filter.update(5), 5.0, 1e-6);
+}
+
+void kalman_settles_on_the_bath() {
+    KalmanFilter filter;
+    // The first sample after a reset is taken as is
+    CHECK_NEAR(filter.update(20), 20.0, 1e-6);
+
+    // Alternating probe noise of 0.1 degrees around a steady bath
+    float estimate = 0;
+    for(int i = 0; i < 200; i++) {
+        estimate = filter.update(i % 2 ? 20.1f : 19.9f);
+    }
+    CHECK_NEAR(estimate, 20.0, 0.03);
+
+    // A step in the bath is followed within a few dozen samples
+    int settled = -1;
+    for(int i = 0; i < 100 && settled < 0; i++) {
+        if(filter.update(25) > 24.9f) {
+            settled = i;
+        }
+    }
+    CHECK(settled > 0 && settled < 50);
+
+    filter.reset();
+    CHECK_NEAR(filter.update(30), 30.0, 1e-6);
+}
+
+} // namespace
+
+int main() {
+    readers_never_see_a_torn_reading();
+    moving_average_fills_then_slides();
+    kalman_settles_on_the_bath();
+    return check_result();
+}
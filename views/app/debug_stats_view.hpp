@@ -0,0 +1,201 @@
+#pragma once
+
+#include "../../film_developer_events.hpp"
+#include "../../instrumentation.hpp"
+#include "../../models/guard.hpp"
+#include "../common/view_cpp.hpp"
+#include <gui/canvas.h>
+#include <gui/elements.h>
+#include <stdio.h>
+
+/**
+ * @brief Read-only pages of MemoryStats and PerfStats, one line per record,
+ * scrolled with Up/Down and switched with Left/Right. The timing page is
+ * redrawn while the process ticks, so it shows the live numbers, and ends
+ * with the contention counters of the watched lock. Back is left to the
+ * app's navigation.
+ */
+class DebugStatsView : public flipper::ViewCpp {
+public:
+    enum class Page : uint8_t {
+        Memory,
+        Perf
+    };
+
+    // Called by the app before the view is shown
+    void show_page(Page next) {
+        page = next;
+        first_line = 0;
+    }
+
+    // Lock whose counters the timing page shows, nullptr for none
+    void watch_lock(const ProtectedLock* lock) {
+        watched_lock = lock;
+    }
+
+    void draw(Canvas* canvas, void*) override {
+        canvas_clear(canvas);
+        canvas_set_font(canvas, FontPrimary);
+        canvas_draw_str(canvas, 2, 10, page == Page::Memory ? "Memory" : "Timing");
+
+        canvas_set_font(canvas, FontSecondary);
+        size_t count = line_count();
+        for(size_t row = 0; row < VISIBLE_LINES && first_line + row < count; row++) {
+            char line[LINE_LENGTH];
+            format_line(first_line + row, line, sizeof(line));
+            canvas_draw_str(canvas, 2, 21 + row * 10, line);
+        }
+        if(count > VISIBLE_LINES) {
+            elements_scrollbar(canvas, first_line, count - VISIBLE_LINES + 1);
+        }
+    }
+
+    bool input(InputEvent* event) override {
+        if(event->type != InputTypeShort && event->type != InputTypeRepeat) {
+            return false;
+        }
+        switch(event->key) {
+        case InputKeyUp:
+            if(first_line > 0) {
+                first_line--;
+                redraw();
+            }
+            return true;
+        case InputKeyDown:
+            if(first_line + VISIBLE_LINES < line_count()) {
+                first_line++;
+                redraw();
+            }
+            return true;
+        case InputKeyLeft:
+        case InputKeyRight:
+            show_page(page == Page::Memory ? Page::Perf : Page::Memory);
+            redraw();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool custom(uint32_t event) override {
+        if(event != static_cast<uint32_t>(FilmDeveloperEvent::TimerTick) || page != Page::Perf) {
+            return false;
+        }
+        uint32_t now = furi_get_tick();
+        if(now - last_refresh_at >= LIVE_REFRESH_MS) {
+            last_refresh_at = now;
+            redraw();
+        }
+        return true;
+    }
+
+    void enter() override {
+        first_line = 0;
+    }
+
+private:
+    static constexpr size_t VISIBLE_LINES = 5;
+    static constexpr size_t LINE_LENGTH = 40;
+    // App stack and heap summary before the per-record lines
+    static constexpr size_t SUMMARY_LINES = 2;
+    // Legend before the timing lines
+    static constexpr size_t PERF_HEADER_LINES = 1;
+    // Contention counters after the timing lines
+    static constexpr size_t LOCK_LINES = 2;
+    // Ticks can come at every turn of the motor, the table doesn't need to
+    // follow every one
+    static constexpr uint32_t LIVE_REFRESH_MS = 500;
+
+    Page page = Page::Memory;
+    size_t first_line = 0;
+    uint32_t last_refresh_at = 0;
+    const ProtectedLock* watched_lock = nullptr;
+
+    void redraw() {
+        // Committing the view model triggers the redraw
+        auto handle = get_model<flipper::ViewContext>();
+        UNUSED(handle);
+    }
+
+    size_t line_count() const {
+        if(page == Page::Perf) {
+            return PERF_HEADER_LINES + PerfStats::get_count() +
+                   (watched_lock != nullptr ? LOCK_LINES : 0);
+        }
+        return SUMMARY_LINES + MemoryStats::get_stack_count() + MemoryStats::get_heap_count();
+    }
+
+    void format_line(size_t index, char* line, size_t size) const {
+        if(page == Page::Perf) {
+            format_perf_line(index, line, size);
+            return;
+        }
+        if(index == 0) {
+            snprintf(
+                line,
+                size,
+                "App stack left: %lu",
+                static_cast<unsigned long>(MemoryStats::app_stack_free()));
+            return;
+        }
+        if(index == 1) {
+            snprintf(
+                line,
+                size,
+                "Heap: %lu (min %lu)",
+                static_cast<unsigned long>(memmgr_get_free_heap()),
+                static_cast<unsigned long>(memmgr_get_minimum_free_heap()));
+            return;
+        }
+        index -= SUMMARY_LINES;
+        if(index < MemoryStats::get_stack_count()) {
+            const auto& record = MemoryStats::get_stack(index);
+            snprintf(
+                line, size, "S %s: %lu", record.name, static_cast<unsigned long>(record.peak));
+            return;
+        }
+        index -= MemoryStats::get_stack_count();
+        const auto& record = MemoryStats::get_heap(index);
+        snprintf(line, size, "H %s: %ld", record.name, static_cast<long>(record.used));
+    }
+
+    void format_perf_line(size_t index, char* line, size_t size) const {
+        if(index == 0) {
+            snprintf(line, size, "us: avg/p99/max");
+            return;
+        }
+        index -= PERF_HEADER_LINES;
+        PerfStats::Record record;
+        if(!PerfStats::get(index, record)) {
+            format_lock_line(index - PerfStats::get_count(), line, size);
+            return;
+        }
+        snprintf(
+            line,
+            size,
+            "%.12s %lu/%lu/%lu",
+            record.name,
+            static_cast<unsigned long>(PerfStats::to_us(record.average())),
+            static_cast<unsigned long>(PerfStats::to_us(record.p99())),
+            static_cast<unsigned long>(PerfStats::to_us(record.max)));
+    }
+
+    void format_lock_line(size_t index, char* line, size_t size) const {
+        LockStats stats = watched_lock->get_stats();
+        if(index == 0) {
+            snprintf(
+                line,
+                size,
+                "Lock %lu, %lu waited",
+                static_cast<unsigned long>(stats.acquisitions),
+                static_cast<unsigned long>(stats.contended));
+            return;
+        }
+        snprintf(
+            line,
+            size,
+            "Wait ticks %lu, max %lu",
+            static_cast<unsigned long>(stats.total_wait_ticks),
+            static_cast<unsigned long>(stats.max_wait_ticks));
+    }
+};
@@ -13,6 +13,7 @@ public:
     add_item("Runtime Settings", 1, process_callback, this);
     add_item("Restart Step", 2, process_callback, this);
     add_item("Skip Step", 3, process_callback, this);
+    add_item("Memory Stats", 4, process_callback, this);
   }
 
 private:
@@ -36,6 +37,10 @@ private:
       view->send_custom_event(
           static_cast<uint32_t>(FilmDeveloperEvent::SkipRequested));
       break;
+    case 4: // Memory Stats
+      view->send_custom_event(
+          static_cast<uint32_t>(FilmDeveloperEvent::DebugStatsRequested));
+      break;
     }
   }
 };
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include <furi.h>
 #include <furi_hal_resources.h>
 #include <gui/elements.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #define MAIN_VIEW_TAG "MainView"
 class MainDevelopmentView : public flipper::ViewCpp {
@@ -18,10 +20,25 @@ public:
 private:
     ProtectedModel& model;
 
+    // What the last draw showed. Only draw writes it, under the shared
+    // lock, and it is read under the exclusive one.
+    Model::DisplaySnapshot drawn;
+
+    // Parts of the screen that changed since the last draw. While a draw
+    // holds the model nothing is reported, the next tick checks again.
+    uint8_t pending_changes() {
+        auto m = model.try_lock(0);
+        if(!m) {
+            return 0;
+        }
+        return m->display_snapshot().dirty_since(drawn);
+    }
+
 protected:
     void draw(Canvas* canvas, void*) override {
+        PROFILE_SCOPE("Main draw");
         FURI_LOG_T(MAIN_VIEW_TAG, "Drawing");
-        auto m = model.lock();
+        auto m = model.read();
         auto* process_interpreter = m->process_interpreter;
         auto* motor_controller = m->motor_controller;
 
@@ -29,14 +46,14 @@ protected:
             return;
         }
 
+        Model::DisplaySnapshot current = m->display_snapshot();
+        drawn = current;
+
         canvas_clear(canvas);
         canvas_set_font(canvas, FontPrimary);
 
         // Draw title
-        char process_name[32];
-        process_interpreter->getProcessName(
-            process_interpreter->getCurrentProcessIndex(), process_name, sizeof(process_name));
-        canvas_draw_str(canvas, 2, 12, process_name);
+        canvas_draw_str(canvas, 2, 12, m->process_name);
 
         // Draw current step info
         canvas_set_font(canvas, FontSecondary);
@@ -55,16 +72,33 @@ protected:
         }
 
         // Draw pin states
-        if(motor_controller->isRunning()) {
-            if(motor_controller->isClockwise()) {
-                canvas_draw_str(canvas, 2, 60, "CW:");
-            } else {
-                canvas_draw_str(canvas, 2, 60, "CCW:");
-            }
+        switch(current.motor) {
+        case MotorController::Direction::Clockwise:
+            canvas_draw_str(canvas, 2, 60, "CW:");
             canvas_draw_str(canvas, 50, 60, "ON");
-        } else {
+            break;
+        case MotorController::Direction::CounterClockwise:
+            canvas_draw_str(canvas, 2, 60, "CCW:");
+            canvas_draw_str(canvas, 50, 60, "ON");
+            break;
+        case MotorController::Direction::Stopped:
             canvas_draw_str(canvas, 2, 60, "CW/CCW:");
             canvas_draw_str(canvas, 50, 60, "OFF");
+            break;
+        }
+
+        // Probe temperature, when a probe answers
+        if(current.temperature_tenths != Model::NO_TEMPERATURE) {
+            int tenths = current.temperature_tenths;
+            char temperature[12];
+            snprintf(
+                temperature,
+                sizeof(temperature),
+                "%s%d.%dC",
+                tenths < 0 ? "-" : "",
+                abs(tenths) / 10,
+                abs(tenths) % 10);
+            canvas_draw_str_aligned(canvas, 126, 60, AlignRight, AlignBottom, temperature);
         }
 
         // Draw control hint - only show OK button hint
@@ -83,11 +117,16 @@ protected:
     }
 
     bool input(InputEvent* event) override {
+        if(event->type == InputTypeLong && event->key == InputKeyOk) {
+            // Hidden timing page
+            send_custom_event(static_cast<uint32_t>(FilmDeveloperEvent::PerfStatsRequested));
+            return true;
+        }
         if(event->type != InputTypeShort) {
             return false;
         }
 
-        auto m = model.lock();
+        auto m = model.read();
 
         switch(event->key) {
         case InputKeyOk:
@@ -132,7 +171,13 @@ protected:
 
     bool custom(uint32_t event) override {
         if(event == static_cast<uint32_t>(FilmDeveloperEvent::TimerTick)) {
-            FURI_LOG_T(MAIN_VIEW_TAG, "Timer tick event");
+            uint8_t dirty = pending_changes();
+            if(dirty == 0) {
+                // Nothing visible changed, don't commit the view model
+                FURI_LOG_T(MAIN_VIEW_TAG, "Timer tick event, nothing to redraw");
+                return true;
+            }
+            FURI_LOG_T(MAIN_VIEW_TAG, "Timer tick event, dirty 0x%02x", dirty);
             redraw();
             return true;
         }
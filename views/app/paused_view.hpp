@@ -14,7 +14,8 @@ public:
 
 protected:
     void draw(Canvas* canvas, void*) override {
-        auto m = model.lock();
+        auto m = model.read();
+        drawn = m->display_snapshot();
 
         canvas_clear(canvas);
         canvas_set_font(canvas, FontPrimary);
@@ -62,6 +63,29 @@ protected:
         }
     }
 
+    bool custom(uint32_t event) override {
+        if(event != static_cast<uint32_t>(FilmDeveloperEvent::TimerTick)) {
+            return false;
+        }
+        bool changed;
+        {
+            // Skipped while a draw holds the model, the next tick checks again
+            auto m = model.try_lock(0);
+            changed = m && (m->display_snapshot().dirty_since(drawn) & SHOWN_FIELDS) != 0;
+        }
+        if(changed) {
+            // Committing the view model triggers the redraw
+            auto handle = get_model<Model>();
+            UNUSED(handle);
+        }
+        return true;
+    }
+
 private:
+    // Only the step and time lines depend on the model
+    static constexpr uint8_t SHOWN_FIELDS = Model::DirtyStep | Model::DirtyTime;
+
     ProtectedModel& model;
+    // What the last draw showed, only accessed with the model locked
+    Model::DisplaySnapshot drawn;
 };
@@ -1,51 +1,505 @@
 #pragma once
 
-#include "../common/submenu_cpp.hpp"
-#include "../../agitation/process_interpreter_interface.hpp"
+#include "../common/view_cpp.hpp"
+#include "../../agitation/process_library.hpp"
 #include "../../film_developer_events.hpp"
+#include <ctype.h>
+#include <gui/canvas.h>
+#include <gui/elements.h>
+#include <stdio.h>
+#include <string.h>
 
-class ProcessSelectionView : public flipper::SubMenuCpp {
+/**
+ * @brief The process list, drawn a window of rows at a time so it costs the
+ * same memory for ten recipes as for a thousand.
+ *
+ * Only the names of the visible rows are read from the library, when the
+ * window moves, and the film and chemistry of the selected one.
+ *
+ * Holding OK starts a search: Up/Down change the last character, Right adds
+ * one, Left removes one and OK goes back to the list, keeping the search.
+ * The list shows the processes whose name, film or chemistry contain the
+ * text, case ignored. Back clears the search, then leaves the view.
+ *
+ * The entries found for each length of the search are kept as bitmaps with
+ * a bit per possible entry, so a longer search only tests the entries the
+ * shorter one found and Left goes back without reading anything. Testing
+ * runs SEARCH_CHUNK records at a time, each from a ProcessSearchStep event
+ * the view sends itself, so keys are handled between steps and the list
+ * fills in as matches are found.
+ *
+ * The search and the library are only used on the dispatcher thread. What
+ * draw() shows is copied into `shown` under the view model lock once the
+ * library has been read, so the GUI thread never waits for the SD card.
+ */
+class ProcessSelectionView : public flipper::ViewCpp {
 public:
-    ProcessSelectionView(ProcessInterpreterInterface* interpreter)
-        : interpreter(interpreter) {
+    // Called by the app before init(), the library outlives the view
+    void set_library(ProcessLibrary* library) {
+        this->library = library;
     }
 
     void init() override {
-        SubMenuCpp::init();
-        set_header("Select Process");
+        ViewCpp::init();
+        clear_filter();
+        publish(READ_ROWS | READ_DETAIL);
+    }
+
+    // Library entry of the selected process, past the end if nothing is
+    // listed
+    size_t get_selected_entry() const {
+        return selected < listed_count() ? entry_at(selected) : MAX_ENTRIES;
+    }
 
-        // Clear existing process names
-        process_count = 0;
+protected:
+    void draw(Canvas* canvas, void*) override {
+        canvas_clear(canvas);
+        char line[MAX_FILTER + 16];
+        size_t filter_length = strlen(shown.filter);
+        if(shown.editing) {
+            canvas_set_font(canvas, FontSecondary);
+            snprintf(
+                line,
+                sizeof(line),
+                "Find: %.*s[%c]",
+                static_cast<int>(filter_length - 1),
+                shown.filter,
+                shown.filter[filter_length - 1]);
+            canvas_draw_str(canvas, 2, 9, line);
+        } else if(filter_length > 0) {
+            canvas_set_font(canvas, FontSecondary);
+            snprintf(line, sizeof(line), "Find: %s", shown.filter);
+            canvas_draw_str(canvas, 2, 9, line);
+        } else {
+            canvas_set_font(canvas, FontPrimary);
+            canvas_draw_str(canvas, 2, 10, "Processes");
+        }
 
-        // Add process options using the interpreter
-        for(size_t i = 0; i < interpreter->getProcessCount() && i < MAX_PROCESSES; ++i) {
-            if(interpreter->getProcessName(i, process_names[i], sizeof(process_names[i]))) {
-                add_item(process_names[i], i, process_callback, this);
-                process_count++;
+        canvas_set_font(canvas, FontSecondary);
+        if(shown.count == 0) {
+            canvas_draw_str_aligned(
+                canvas,
+                64,
+                32,
+                AlignCenter,
+                AlignCenter,
+                shown.searching ? "Searching..." : "No match");
+            return;
+        }
+        // A + while more may still be found
+        snprintf(
+            line,
+            sizeof(line),
+            "%u/%u%s",
+            static_cast<unsigned int>(shown.selected + 1),
+            static_cast<unsigned int>(shown.count),
+            shown.searching ? "+" : "");
+        canvas_draw_str_aligned(canvas, 126, 9, AlignRight, AlignBottom, line);
+
+        for(size_t row = 0; row < shown.rows; row++) {
+            int32_t y = ROWS_Y + row * ROW_HEIGHT;
+            if(shown.top + row == shown.selected) {
+                canvas_draw_box(canvas, 0, y, ROW_WIDTH, ROW_HEIGHT);
+                canvas_set_color(canvas, ColorWhite);
             }
+            canvas_draw_str(canvas, 3, y + 8, shown.names[row]);
+            canvas_set_color(canvas, ColorBlack);
+        }
+        if(shown.count > VISIBLE_ROWS) {
+            elements_scrollbar_pos(
+                canvas, 128, ROWS_Y, VISIBLE_ROWS * ROW_HEIGHT, shown.selected, shown.count);
         }
+
+        canvas_draw_line(canvas, 0, DETAIL_Y - 9, 127, DETAIL_Y - 9);
+        canvas_draw_str(canvas, 2, DETAIL_Y, shown.detail);
     }
 
-    const char* get_selected_process() const {
-        size_t index = get_selected_item();
-        if(index < process_count) {
-            return process_names[index];
+    bool input(InputEvent* event) override {
+        if(event->type == InputTypeLong && event->key == InputKeyOk && !editing) {
+            if(filter_length == 0) {
+                add_character();
+            }
+            editing = true;
+            publish(READ_ROWS | READ_DETAIL);
+            return true;
+        }
+        if(event->type != InputTypeShort && event->type != InputTypeRepeat) {
+            return false;
         }
-        return nullptr;
+        if(editing) {
+            return edit_filter(event->key);
+        }
+        return navigate(event->key, event->type);
+    }
+
+    bool custom(uint32_t event) override {
+        if(event != static_cast<uint32_t>(FilmDeveloperEvent::ProcessSearchStep)) {
+            return false;
+        }
+        step_pending = false;
+        search_step();
+        return true;
+    }
+
+    void enter() override {
+        // A step sent while another view was shown went to the app instead
+        step_pending = false;
+        schedule_step();
     }
 
 private:
-    static constexpr size_t MAX_PROCESSES = 16;
-    static constexpr size_t MAX_NAME_LENGTH = 32;
+    static constexpr size_t MAX_ENTRIES = AGITATION_PROCESS_COUNT + ProcessLibrary::MAX_RECIPES;
+    static constexpr size_t BITMAP_WORDS = (MAX_ENTRIES + 31) / 32;
+    // A bitmap is kept per character
+    static constexpr size_t MAX_FILTER = 8;
+    static constexpr const char* ALPHABET = "abcdefghijklmnopqrstuvwxyz0123456789 +-";
+    // Records tested per search step, about 4 KB of the index
+    static constexpr size_t SEARCH_CHUNK = 32;
+
+    static constexpr size_t VISIBLE_ROWS = 4;
+    static constexpr int32_t ROWS_Y = 12;
+    static constexpr size_t ROW_HEIGHT = 10;
+    static constexpr size_t ROW_WIDTH = 123;
+    static constexpr int32_t DETAIL_Y = 62;
+
+    // What publish() reads from the library
+    static constexpr uint8_t READ_ROWS = 1 << 0;
+    static constexpr uint8_t READ_DETAIL = 1 << 1;
+
+    // Everything draw() uses
+    struct Shown {
+        char filter[MAX_FILTER + 1];
+        bool editing;
+        bool searching;
+        size_t selected;
+        size_t top;
+        size_t count;
+        size_t rows;
+        char names[VISIBLE_ROWS][LoadedProcess::MAX_TEXT];
+        char detail[LoadedProcess::MAX_TEXT * 2];
+    };
 
-    ProcessInterpreterInterface* interpreter;
-    char process_names[MAX_PROCESSES][MAX_NAME_LENGTH];
-    size_t process_count = 0;
+    ProcessLibrary* library = nullptr;
+
+    // levels[i] marks the entries containing the first i + 1 characters of
+    // the filter. Levels below complete_levels are final, the next one is
+    // tested up to scan_entry while the filter is longer.
+    uint32_t levels[MAX_FILTER][BITMAP_WORDS];
+    size_t level_counts[MAX_FILTER]{};
+    size_t complete_levels = 0;
+    size_t scan_entry = 0;
+    bool step_pending = false;
+
+    // Characters of ALPHABET only, so already lower case
+    char filter[MAX_FILTER + 1]{};
+    size_t filter_length = 0;
+    bool editing = false;
+
+    // Positions among the listed entries
+    size_t selected = 0;
+    size_t top = 0;
+    // Recipes that failed to parse are listed with their error but cannot
+    // be selected
+    bool selected_loads = false;
+
+    // Filled by publish() without the lock, then copied into shown with it
+    Shown staged{};
+    Shown shown{};
+
+    bool navigate(InputKey key, InputType type) {
+        switch(key) {
+        case InputKeyUp:
+            move(-1, type == InputTypeShort);
+            return true;
+        case InputKeyDown:
+            move(1, type == InputTypeShort);
+            return true;
+        case InputKeyLeft:
+            move(-static_cast<int32_t>(VISIBLE_ROWS), false);
+            return true;
+        case InputKeyRight:
+            move(VISIBLE_ROWS, false);
+            return true;
+        case InputKeyOk:
+            if(type == InputTypeShort && listed_count() > 0 && selected_loads) {
+                send_custom_event(static_cast<uint32_t>(FilmDeveloperEvent::ProcessSelected));
+            }
+            return true;
+        case InputKeyBack:
+            if(type != InputTypeShort || filter_length == 0) {
+                return false;
+            }
+            clear_filter();
+            publish(READ_ROWS | READ_DETAIL);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    bool edit_filter(InputKey key) {
+        switch(key) {
+        case InputKeyUp:
+            change_character(1);
+            break;
+        case InputKeyDown:
+            change_character(-1);
+            break;
+        case InputKeyRight:
+            add_character();
+            break;
+        case InputKeyLeft:
+            remove_character();
+            editing = filter_length > 0;
+            break;
+        case InputKeyOk:
+            editing = false;
+            break;
+        case InputKeyBack:
+            clear_filter();
+            break;
+        default:
+            return false;
+        }
+        publish(READ_ROWS | READ_DETAIL);
+        return true;
+    }
+
+    void move(int32_t delta, bool wrap) {
+        size_t count = listed_count();
+        if(count == 0) {
+            return;
+        }
+        int32_t last = static_cast<int32_t>(count) - 1;
+        int32_t position = static_cast<int32_t>(selected) + delta;
+        if(position < 0) {
+            position = wrap && selected == 0 ? last : 0;
+        } else if(position > last) {
+            position = wrap && static_cast<int32_t>(selected) == last ? 0 : last;
+        }
+        selected = static_cast<size_t>(position);
+
+        size_t first = top;
+        if(selected < top) {
+            top = selected;
+        } else if(selected >= top + VISIBLE_ROWS) {
+            top = selected - VISIBLE_ROWS + 1;
+        }
+        publish(top != first ? READ_ROWS | READ_DETAIL : READ_DETAIL);
+    }
+
+    void clear_filter() {
+        filter_length = 0;
+        filter[0] = '\0';
+        editing = false;
+        complete_levels = 0;
+        show_first();
+    }
+
+    void add_character() {
+        if(filter_length == MAX_FILTER) {
+            return;
+        }
+        filter[filter_length++] = ALPHABET[0];
+        filter[filter_length] = '\0';
+        clear_level(filter_length - 1);
+        if(complete_levels == filter_length - 1) {
+            scan_entry = 0;
+        }
+        show_first();
+        schedule_step();
+    }
+
+    void change_character(int32_t step) {
+        int32_t size = static_cast<int32_t>(strlen(ALPHABET));
+        int32_t current = static_cast<int32_t>(strchr(ALPHABET, filter[filter_length - 1]) - ALPHABET);
+        filter[filter_length - 1] = ALPHABET[(current + step + size) % size];
+        clear_level(filter_length - 1);
+        if(complete_levels >= filter_length - 1) {
+            complete_levels = filter_length - 1;
+            scan_entry = 0;
+        }
+        show_first();
+        schedule_step();
+    }
+
+    // The shorter filter's level is kept, nothing is read
+    void remove_character() {
+        filter[--filter_length] = '\0';
+        if(complete_levels > filter_length) {
+            complete_levels = filter_length;
+        }
+        show_first();
+    }
 
-    static void process_callback(void* context, uint32_t index) {
-        auto view = static_cast<ProcessSelectionView*>(context);
-        if(index < view->interpreter->getProcessCount()) {
-            view->send_custom_event(static_cast<uint32_t>(FilmDeveloperEvent::ProcessSelected));
+    void show_first() {
+        selected = 0;
+        top = 0;
+    }
+
+    void clear_level(size_t level) {
+        memset(levels[level], 0, sizeof(levels[level]));
+        level_counts[level] = 0;
+    }
+
+    bool is_searching() const {
+        return complete_levels < filter_length;
+    }
+
+    void schedule_step() {
+        if(is_searching() && !step_pending) {
+            step_pending = true;
+            send_custom_event(static_cast<uint32_t>(FilmDeveloperEvent::ProcessSearchStep));
+        }
+    }
+
+    // Tests the next SEARCH_CHUNK entries for the level being filled
+    void search_step() {
+        if(!is_searching() || !library) {
+            return;
+        }
+        size_t level = complete_levels;
+        size_t count = entry_count();
+        const uint32_t* from = level == 0 ? nullptr : levels[level - 1];
+        size_t first = next_set(from, scan_entry, count);
+        size_t last = first + SEARCH_CHUNK < count ? first + SEARCH_CHUNK : count;
+        library->for_each_summary(first, last, [&](size_t entry, const ProcessSummary& summary) {
+            if((!from || is_set(from, entry)) && summary_contains(summary, level + 1)) {
+                levels[level][entry / 32] |= 1u << (entry % 32);
+                level_counts[level]++;
+            }
+        });
+        scan_entry = last;
+        if(scan_entry >= count) {
+            complete_levels++;
+            scan_entry = 0;
+        }
+
+        // Matches are found in list order, so only a window that is not
+        // full yet can change
+        bool listed = level == filter_length - 1;
+        publish(listed && staged.rows < VISIBLE_ROWS ? READ_ROWS | READ_DETAIL : 0);
+        schedule_step();
+    }
+
+    // Reads what the flags ask for, then hands it all to draw()
+    void publish(uint8_t read) {
+        staged.editing = editing;
+        staged.searching = is_searching();
+        staged.selected = selected;
+        staged.top = top;
+        staged.count = listed_count();
+        memcpy(staged.filter, filter, sizeof(filter));
+        if(read & READ_ROWS) {
+            read_rows();
+        }
+        if(read & READ_DETAIL) {
+            read_detail();
+        }
+
+        // Committing the view model redraws
+        auto handle = get_model<flipper::ViewContext>();
+        shown = staged;
+    }
+
+    void read_rows() {
+        staged.rows = 0;
+        ProcessSummary summary;
+        for(size_t position = top; position < staged.count && staged.rows < VISIBLE_ROWS;
+            position++) {
+            if(!library->get_summary(entry_at(position), summary)) {
+                break;
+            }
+            snprintf(staged.names[staged.rows], sizeof(staged.names[0]), "%s", summary.name);
+            staged.rows++;
+        }
+    }
+
+    void read_detail() {
+        staged.detail[0] = '\0';
+        selected_loads = false;
+        ProcessSummary summary;
+        if(selected >= staged.count || !library->get_summary(entry_at(selected), summary)) {
+            return;
+        }
+        selected_loads = summary.step_count > 0;
+        snprintf(
+            staged.detail,
+            sizeof(staged.detail),
+            "%s%s%s",
+            summary.film,
+            summary.film[0] && summary.chemistry[0] ? ", " : "",
+            summary.chemistry);
+    }
+
+    bool summary_contains(const ProcessSummary& summary, size_t length) const {
+        return contains(summary.film, length) || contains(summary.chemistry, length) ||
+               contains(summary.name, length);
+    }
+
+    bool contains(const char* text, size_t length) const {
+        for(; *text; text++) {
+            size_t i = 0;
+            while(i < length && text[i] &&
+                  tolower(static_cast<unsigned char>(text[i])) == filter[i]) {
+                i++;
+            }
+            if(i == length) {
+                return true;
+            }
+        }
+        return length == 0;
+    }
+
+    size_t entry_count() const {
+        size_t count = library ? library->get_count() : 0;
+        return count < MAX_ENTRIES ? count : MAX_ENTRIES;
+    }
+
+    // Entries listed for the filter, those found so far while searching
+    size_t listed_count() const {
+        return filter_length == 0 ? entry_count() : level_counts[filter_length - 1];
+    }
+
+    static bool is_set(const uint32_t* bits, size_t entry) {
+        return entry < MAX_ENTRIES && (bits[entry / 32] >> (entry % 32)) & 1u;
+    }
+
+    // First entry from start on that is set, any entry for nullptr
+    static size_t next_set(const uint32_t* bits, size_t start, size_t count) {
+        if(!bits) {
+            return start < count ? start : count;
+        }
+        for(size_t entry = start; entry < count;) {
+            uint32_t word = bits[entry / 32] >> (entry % 32);
+            if(word != 0) {
+                entry += __builtin_ctz(word);
+                return entry < count ? entry : count;
+            }
+            entry = (entry / 32 + 1) * 32;
+        }
+        return count;
+    }
+
+    // Library entry listed at a position, the position-th set bit of the
+    // filter's level
+    size_t entry_at(size_t position) const {
+        if(filter_length == 0) {
+            return position;
+        }
+        const uint32_t* bits = levels[filter_length - 1];
+        for(size_t word = 0; word < BITMAP_WORDS; word++) {
+            size_t count = __builtin_popcount(bits[word]);
+            if(position >= count) {
+                position -= count;
+                continue;
+            }
+            uint32_t remaining = bits[word];
+            for(; position > 0; position--) {
+                remaining &= remaining - 1;
+            }
+            return word * 32 + __builtin_ctz(remaining);
         }
+        return MAX_ENTRIES;
     }
 };
@@ -14,8 +14,6 @@ public:
     void init() override {
         flipper::VariableItemListCpp::init();
 
-        auto m = model.lock();
-
         // Add push/pull setting
         push_pull_item =
             add_item("Push/Pull", Model::PUSH_PULL_COUNT, push_pull_change_callback, this);
@@ -29,16 +27,35 @@ public:
         set_current_value_index(roll_count_item, 0); // Default to 1 roll
         update_roll_count_text(1);
 
-        add_item("Confirm", 0, nullptr, nullptr);
+        confirm_item = add_item("Confirm", 0, nullptr, nullptr);
 
         // Set enter callback for confirmation
         set_enter_callback(enter_callback, this);
     }
 
+    // Shows the model's current settings, e.g. after the view was recreated.
+    // The caller holds the model lock.
+    void sync(const Model& model) {
+        uint8_t push_pull_index = static_cast<uint8_t>(model.push_pull_stops + 1);
+        set_current_value_index(push_pull_item, push_pull_index);
+        set_current_value_text(push_pull_item, Model::PUSH_PULL_VALUES[push_pull_index]);
+
+        set_current_value_index(roll_count_item, model.roll_count - 1);
+        update_roll_count_text(model.roll_count);
+        set_current_value_text(confirm_item, "");
+    }
+
+    // Shown on Confirm when the selected process could not be loaded, e.g.
+    // a recipe deleted since the list was read. Cleared by sync().
+    void show_load_error() {
+        set_current_value_text(confirm_item, "Load failed");
+    }
+
 private:
     ProtectedModel& model;
     VariableItem* push_pull_item = nullptr;
     VariableItem* roll_count_item = nullptr;
+    VariableItem* confirm_item = nullptr;
 
     static void push_pull_change_callback(VariableItem* item) {
         auto view = static_cast<SettingsView*>(get_context(item));
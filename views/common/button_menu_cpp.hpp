@@ -11,8 +11,13 @@ public:
     }
 
     ~ButtonMenuCpp() {
+        ButtonMenuCpp::deinit();
+    }
+
+    void deinit() override {
         if(button_menu) {
             button_menu_free(button_menu);
+            button_menu = nullptr;
             view = nullptr;
         }
     }
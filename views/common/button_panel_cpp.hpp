@@ -11,8 +11,13 @@ public:
     }
 
     ~ButtonPanelCpp() {
+        ButtonPanelCpp::deinit();
+    }
+
+    void deinit() override {
         if(button_panel) {
             button_panel_free(button_panel);
+            button_panel = nullptr;
             view = nullptr;
         }
     }
@@ -11,8 +11,13 @@ public:
     }
 
     ~ByteInputCpp() {
+        ByteInputCpp::deinit();
+    }
+
+    void deinit() override {
         if(byte_input) {
             byte_input_free(byte_input);
+            byte_input = nullptr;
             view = nullptr;
         }
     }
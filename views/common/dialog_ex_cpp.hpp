@@ -10,8 +10,13 @@ public:
   DialogExCpp() {}
 
   ~DialogExCpp() {
+    DialogExCpp::deinit();
+  }
+
+  void deinit() override {
     if (dialog) {
       dialog_ex_free(dialog);
+      dialog = nullptr;
       view = nullptr;
     }
   }
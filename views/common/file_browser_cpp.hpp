@@ -12,8 +12,13 @@ public:
     }
 
     ~FileBrowserCpp() {
+        FileBrowserCpp::deinit();
+    }
+
+    void deinit() override {
         if(browser) {
             file_browser_free(browser);
+            browser = nullptr;
             view = nullptr;
         }
     }
@@ -11,8 +11,13 @@ public:
     }
 
     ~LoadingCpp() {
+        LoadingCpp::deinit();
+    }
+
+    void deinit() override {
         if(loading) {
             loading_free(loading);
+            loading = nullptr;
             view = nullptr;
         }
     }
@@ -11,8 +11,13 @@ public:
     }
 
     ~NumberInputCpp() {
+        NumberInputCpp::deinit();
+    }
+
+    void deinit() override {
         if(number_input) {
             number_input_free(number_input);
+            number_input = nullptr;
             view = nullptr;
         }
     }
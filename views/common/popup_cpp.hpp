@@ -11,8 +11,13 @@ public:
     }
 
     ~PopupCpp() {
+        PopupCpp::deinit();
+    }
+
+    void deinit() override {
         if(popup) {
             popup_free(popup);
+            popup = nullptr;
             view = nullptr;
         }
     }
@@ -11,8 +11,13 @@ public:
     }
 
     ~SubMenuCpp() {
+        SubMenuCpp::deinit();
+    }
+
+    void deinit() override {
         if(submenu) {
             submenu_free(submenu);
+            submenu = nullptr;
             view = nullptr;
         }
     }
@@ -11,8 +11,13 @@ public:
     }
 
     ~TextBoxCpp() {
+        TextBoxCpp::deinit();
+    }
+
+    void deinit() override {
         if(text_box) {
             text_box_free(text_box);
+            text_box = nullptr;
             view = nullptr;
         }
     }
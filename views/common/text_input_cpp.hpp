@@ -11,8 +11,13 @@ public:
     }
 
     ~TextInputCpp() {
+        TextInputCpp::deinit();
+    }
+
+    void deinit() override {
         if(text_input) {
             text_input_free(text_input);
+            text_input = nullptr;
             view = nullptr;
         }
     }
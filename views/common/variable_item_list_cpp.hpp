@@ -11,8 +11,13 @@ public:
     }
 
     ~VariableItemListCpp() {
+        VariableItemListCpp::deinit();
+    }
+
+    void deinit() override {
         if(variable_item_list) {
             variable_item_list_free(variable_item_list);
+            variable_item_list = nullptr;
             view = nullptr;
         }
     }
@@ -55,12 +55,19 @@ public:
     view_set_exit_callback(view, &ViewCpp::exitWrapper);
   }
 
-  virtual ~ViewCpp() {
+  virtual ~ViewCpp() { ViewCpp::deinit(); }
+
+  // Frees what init() allocated. The view must have been removed from its
+  // dispatcher first; init() may be called again afterwards.
+  virtual void deinit() {
     if (view) {
       view_free(view);
+      view = nullptr;
     }
   }
 
+  bool is_initialized() const { return view != nullptr; }
+
   // Non-copyable
   ViewCpp(const ViewCpp &) = delete;
   ViewCpp &operator=(const ViewCpp &) = delete;
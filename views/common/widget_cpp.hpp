@@ -11,8 +11,13 @@ public:
     }
 
     ~WidgetCpp() {
+        WidgetCpp::deinit();
+    }
+
+    void deinit() override {
         if(widget) {
             widget_free(widget);
+            widget = nullptr;
             view = nullptr;
         }
     }